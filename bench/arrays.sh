@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# Summe über ein Array, dreimal: Schleife mit i < n (jeder Zugriff geprüft),
+# Schleife mit i < len(a) (Bounds-Check-Elimination, ALOAD_NC) und das
+# Builtin sum(). N Elemente, REPS Wiederholungen, bester von RUNS Läufen.
+#
+#   bench/arrays.sh [n] [reps] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+N="${1:-100000}"
+REPS="${2:-200}"
+RUNS="${3:-5}"
+WORK="$(mktemp -d)"
+BUILD="$WORK/build"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$BUILD" >/dev/null 2>&1
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+# $1 = Rumpf der Wiederholungsschleife (summiert nach s)
+gen() {
+    cat <<NOVA
+let n = $N
+let a = array(n)
+let s = 0
+let i = 0
+while (i < len(a)) {
+  a[i] = i & 1023
+  i = i + 1
+}
+let r = 0
+while (r < $REPS) {
+$1
+  r = r + 1
+}
+println(s)
+NOVA
+}
+gen "  i = 0
+  while (i < n) {
+    s = s + a[i]
+    i = i + 1
+  }" > "$WORK/checked.nova"
+gen "  i = 0
+  while (i < len(a)) {
+    s = s + a[i]
+    i = i + 1
+  }" > "$WORK/bce.nova"
+gen "  s = s + sum(a)" > "$WORK/sum.nova"
+
+for v in checked bce sum; do "$BUILD/novac" "$WORK/$v.nova" "$WORK/$v.nvc"; done
+ref=$("$BUILD/novavm" "$WORK/checked.nvc")
+for v in bce sum; do
+    [ "$("$BUILD/novavm" "$WORK/$v.nvc")" = "$ref" ] || echo "warning: $v output differs" >&2
+done
+
+printf "%-8s %10s %10s %10s\n" "engine" "checked" "bce" "sum()"
+for jit in off on; do
+    t=()
+    for v in checked bce sum; do t+=("$(best_ms "$BUILD/novavm" --jit=$jit "$WORK/$v.nvc")"); done
+    printf "%-8s %8sms %8sms %8sms\n" "$jit" "${t[0]}" "${t[1]}" "${t[2]}"
+done
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# novac --batch gegen einen novac-Prozess je Datei, auf einem generierten
+# Baum aus vielen kleinen Quellen (Default 400 Dateien à ~200 Zeilen):
+#   procs:  for f in ...; novac f f.nvc
+#   cold:   --batch mit leerem Cache (Thread-Pool, ein Compiler je Thread)
+#   warm:   --batch ohne Änderungen (alles aus dem Cache)
+#   touch:  --batch, eine Datei geändert
+#
+#   bench/batch.sh [files] [runs] [novac]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+FILES="${1:-400}"
+RUNS="${2:-3}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+if [ -n "${3:-}" ]; then
+    NOVAC="$3"
+else
+    cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+    cmake --build "$WORK/build" >/dev/null 2>&1
+    NOVAC="$WORK/build/novac"
+fi
+
+SRC="$WORK/src"
+for d in $(seq 0 $(( (FILES - 1) / 50 ))); do mkdir -p "$SRC/m$d"; done
+for i in $(seq 0 $((FILES - 1))); do
+    awk -v F="$i" 'BEGIN{
+        for(f=0; f<10; f++){
+            print "func fn_" f "(a, b) {"
+            print "  let t = a * " F % 7 + 3 " + b"
+            print "  if (t > 100) { t = t - 100 }"
+            print "  return t"
+            print "}"
+        }
+        for(i=0; i<150; i++) print "let v_" i % 40 " = fn_" i % 10 "(" i ", " F ")"
+        print "println(v_0)"
+    }' > "$SRC/m$((i / 50))/f$i.nova"
+done
+
+ms() { local t0 t1; t0=$(date +%s%N); "$@" >/dev/null 2>&1 || true; t1=$(date +%s%N); echo $(( (t1 - t0) / 1000000 )); }
+best() { local b=""; for _ in $(seq "$RUNS"); do local t; t=$("$@"); if [ -z "$b" ] || [ "$t" -lt "$b" ]; then b=$t; fi; done; echo "$b"; }
+
+procs() { ms sh -c 'for f in $(find "$1" -name "*.nova"); do "$2" "$f" "${f%.nova}.nvc"; done' _ "$SRC" "$NOVAC"; }
+cold()  { rm -rf "$WORK/cache"; ms "$NOVAC" --batch "$SRC" --cache-dir="$WORK/cache"; }
+warm()  { ms "$NOVAC" --batch "$SRC" --cache-dir="$WORK/cache"; }
+touch1() { echo "println(1)" >> "$SRC/m0/f0.nova"; ms "$NOVAC" --batch "$SRC" --cache-dir="$WORK/cache"; }
+
+printf "%-8s %8s %10s\n" "mode" "files" "total"
+for mode in procs cold warm touch1; do
+    printf "%-8s %8s %8sms\n" "$mode" "$FILES" "$(best $mode)"
+done
+"$NOVAC" --batch "$SRC" --cache-dir="$WORK/cache" | tail -1
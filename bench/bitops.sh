@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# rule30 mit Bitoperatoren gegen die frühere Fassung aus Division/Modulo
+# und 2^x-Schleifen (examples/rule30.nova in einer Vergleichsrevision,
+# Default HEAD~1). Beide laufen auf der aktuellen VM, STEPS wird erhöht,
+# die Ausgabe geht nach /dev/null.
+#
+#   bench/bitops.sh [base-rev] [steps] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+BASE="${1:-HEAD~1}"
+STEPS="${2:-20000}"
+RUNS="${3:-5}"
+WORK="$(mktemp -d)"
+BUILD="$WORK/build"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$BUILD" >/dev/null 2>&1
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+git -C "$ROOT" show "$BASE:examples/rule30.nova" > "$WORK/old.nova"
+cp "$ROOT/examples/rule30.nova" "$WORK/new.nova"
+for v in old new; do
+    sed -i "s/^let STEPS = [0-9]*/let STEPS = $STEPS/" "$WORK/$v.nova"
+    "$BUILD/novac" "$WORK/$v.nova" "$WORK/$v.nvc"
+done
+if ! cmp -s <("$BUILD/novavm" "$WORK/old.nvc") <("$BUILD/novavm" "$WORK/new.nvc"); then
+    echo "warning: outputs differ" >&2
+fi
+
+printf "%-8s %10s %10s %8s\n" "engine" "div/mod" "bitops" "speedup"
+for jit in off on; do
+    a=$(best_ms "$BUILD/novavm" --jit=$jit "$WORK/old.nvc")
+    b=$(best_ms "$BUILD/novavm" --jit=$jit "$WORK/new.nvc")
+    printf "%-8s %8sms %8sms %7sx\n" "$jit" "$a" "$b" \
+        "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')"
+done
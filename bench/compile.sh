@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+# Compile-Durchsatz von novac auf generierten Programmen (Default 100k Zeilen).
+#   wide:   viele verschiedene Bezeichner (globale Variablen + Funktionen mit Locals)
+#   narrow: 200 Globals / 200 Funktionen (innerhalb der alten festen Limits)
+# Neben der Zeit die Spitzen-RSS eines Laufs (braucht python3, sonst "-").
+#
+#   bench/compile.sh [lines] [runs] [novac]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+LINES="${1:-100000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+if [ -n "${3:-}" ]; then
+    NOVAC="$3"
+else
+    cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+    cmake --build "$WORK/build" >/dev/null 2>&1
+    NOVAC="$WORK/build/novac"
+fi
+
+# gen <lines> <nvars> <nfuncs>: Funktionen (5 Zeilen) + Zuweisungen an Globals
+gen() {
+    awk -v N="$1" -v NV="$2" -v NF="$3" 'BEGIN{
+        for(f=0; f<NF; f++){
+            print "func fn_" f "(a, b) {"
+            print "  let t_" f " = a * 3 + b"
+            print "  if (t_" f " > 100) { t_" f " = t_" f " - 100 }"
+            print "  return t_" f
+            print "}"
+        }
+        for(i=0; i<N-5*NF; i++){
+            v = i % NV
+            if(i < NV)          print "let var_" v " = " i % 97
+            else if(i % 5 == 0) print "var_" v " = fn_" (i % NF) "(var_" (i*7) % NV ", " i % 13 ")"
+            else                print "var_" v " = var_" (i*31) % NV " + var_" (i*17) % NV " % 7"
+        }
+        print "println(var_0)"
+    }'
+}
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+# peak_kib cmd...: maximale RSS des Kindprozesses in KiB
+peak_kib() {
+    if ! command -v python3 >/dev/null; then echo "-"; return; fi
+    python3 -c 'import resource, subprocess, sys
+subprocess.run(sys.argv[1:], stdout=subprocess.DEVNULL, check=True)
+print(resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss)' "$@"
+}
+
+printf "%-8s %8s %8s %8s %10s %12s %10s\n" "shape" "lines" "globals" "funcs" "compile" "lines/s" "peak RSS"
+for shape in narrow wide; do
+    if [ "$shape" = narrow ]; then nv=200; nf=200; else nv=$((LINES / 4)); nf=$((LINES / 50)); fi
+    gen "$LINES" "$nv" "$nf" > "$WORK/$shape.nova"
+    if ! "$NOVAC" "$WORK/$shape.nova" "$WORK/$shape.nvc" 2>"$WORK/err"; then
+        printf "%-8s %8s %8s %8s %10s\n" "$shape" "$LINES" "$nv" "$nf" "failed: $(head -c 60 "$WORK/err")"
+        continue
+    fi
+    ms=$(best_ms "$NOVAC" "$WORK/$shape.nova" "$WORK/$shape.nvc")
+    kib=$(peak_kib "$NOVAC" "$WORK/$shape.nova" "$WORK/$shape.nvc")
+    printf "%-8s %8s %8s %8s %8sms %12s %7s KiB\n" "$shape" "$LINES" "$nv" "$nf" "$ms" \
+        "$(awk -v l="$LINES" -v m="$ms" 'BEGIN{ printf "%d", (m>0)? l*1000/m : 0 }')" "$kib"
+done
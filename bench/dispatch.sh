@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# Vergleicht switch- und computed-goto-Dispatch von novavm auf den Beispielen.
+# Die Beispiele laufen in der Originalfassung nur Millisekunden; STEPS wird
+# daher hochgesetzt (Ausgabe nach /dev/null), damit der Interpreter dominiert.
+#
+#   bench/dispatch.sh [steps] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+STEPS="${1:-20000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$WORK/switch"   -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF -DNOVA_THREADED_DISPATCH=OFF >/dev/null
+cmake -S "$ROOT" -B "$WORK/threaded" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF -DNOVA_THREADED_DISPATCH=ON  >/dev/null
+cmake --build "$WORK/switch"   >/dev/null 2>&1
+cmake --build "$WORK/threaded" >/dev/null 2>&1
+
+# bestes von RUNS Läufen in ms
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+printf "%-22s %10s %10s %8s\n" "program" "switch" "threaded" "speedup"
+for ex in rule30 rule30_ascii_min loop; do
+    src="$WORK/$ex.nova"
+    sed -E "s/^(let STEPS *= *)[0-9]+/\1$STEPS/; s/^(while \(i < )5\)/\1${STEPS}000)/" \
+        "$ROOT/examples/$ex.nova" > "$src"
+    "$WORK/threaded/novac" "$src" "$WORK/$ex.nvc"
+    a=$(best_ms "$WORK/switch/novavm"   "$WORK/$ex.nvc")
+    b=$(best_ms "$WORK/threaded/novavm" "$WORK/$ex.nvc")
+    printf "%-22s %8sms %8sms %7sx\n" "$ex" "$a" "$b" \
+        "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')"
+done
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Lexer-Durchsatz von novac (--lex-only: nur Tokens, ohne Parser/Datei-I/O)
+# auf generierten Quelltexten, Default 1M Zeilen (~30 MB):
+#   narrow: wenige Bezeichner (200 Globals, 200 Funktionen)
+#   wide:   viele Bezeichner (Internieren dominiert)
+#   dense:  lange Zeilen mit Operatoren, Zahlen, Strings und Kommentaren
+#
+#   bench/lexer.sh [lines] [runs] [novac]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+LINES="${1:-1000000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+if [ -n "${3:-}" ]; then
+    NOVAC="$3"
+else
+    cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+    cmake --build "$WORK/build" >/dev/null 2>&1
+    NOVAC="$WORK/build/novac"
+fi
+
+gen() {
+    awk -v N="$LINES" -v SHAPE="$1" 'BEGIN{
+        for(i=0; i<N; i++){
+            if(SHAPE == "dense")
+                print "x_" i % 50 " = (a" i % 7 " << 3) + " i " * b_" i % 11 " >= 12 && \"s" i % 100 "\" != y   // c" i
+            else {
+                nv = (SHAPE == "wide") ? N / 4 : 200
+                print "var_" i % nv " = var_" (i*31) % nv " + fn_" i % 200 "(var_" (i*17) % nv ", " i % 13 ")"
+            }
+        }
+    }'
+}
+
+printf "%-8s %10s %10s %10s %10s\n" "shape" "MB" "tokens" "lex" "Mtok/s"
+for shape in narrow wide dense; do
+    gen "$shape" > "$WORK/$shape.nova"
+    best="" line=""
+    for _ in $(seq "$RUNS"); do
+        out=$("$NOVAC" --lex-only "$WORK/$shape.nova")
+        ms=$(echo "$out" | awk '{ print $7 }')
+        if [ -z "$best" ] || awk -v a="$ms" -v b="$best" 'BEGIN{ exit !(a < b) }'; then best=$ms; line=$out; fi
+    done
+    echo "$line" | awk -v s="$shape" '{ printf "%-8s %10.1f %10s %8sms %10s\n", s, $5/1e6, $1, $7, $9 }'
+done
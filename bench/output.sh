@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# Ausgabepfad: stdio (novavm --out-buffer=0) gegen den gepufferten Pfad
+# (Standard, 64 KiB). STEPS wird wie in bench/dispatch.sh hochgesetzt; die
+# Ausgabe geht in eine Datei, damit write(2) tatsächlich etwas kostet.
+#
+#   bench/output.sh [steps] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+STEPS="${1:-20000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$WORK/build" >/dev/null 2>&1
+NOVAC="$WORK/build/novac"; NOVAVM="$WORK/build/novavm"
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >"$WORK/out.txt"; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+printf "%-18s %-6s %10s %10s %8s\n" "program" "engine" "stdio" "buffered" "speedup"
+for ex in rule30 rule30_ascii_min loop; do
+    src="$WORK/$ex.nova"
+    sed -E "s/^(let STEPS *= *)[0-9]+/\1$STEPS/; s/^(while \(i < )5\)/\1${STEPS}00)/" \
+        "$ROOT/examples/$ex.nova" > "$src"
+    "$NOVAC" "$src" "$WORK/$ex.nvc"
+    for jit in off on; do
+        a=$(best_ms "$NOVAVM" --jit=$jit --out-buffer=0 "$WORK/$ex.nvc")
+        b=$(best_ms "$NOVAVM" --jit=$jit "$WORK/$ex.nvc")
+        printf "%-18s %-6s %8sms %8sms %7sx\n" "$ex" "$jit" "$a" "$b" \
+            "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')"
+    done
+done
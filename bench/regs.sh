@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+# Stack- gegen Register-Bytecode (novac --regs) auf den Beispielen.
+# STEPS wird wie in bench/dispatch.sh hochgesetzt, Ausgabe nach /dev/null.
+#
+#   bench/regs.sh [steps] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+STEPS="${1:-20000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$WORK/build" >/dev/null 2>&1
+NOVAC="$WORK/build/novac"; NOVAVM="$WORK/build/novavm"
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+printf "%-18s %10s %10s %8s %14s\n" "program" "stack" "regs" "speedup" "bytes stk/reg"
+for ex in rule30 rule30_ascii_min loop; do
+    src="$WORK/$ex.nova"
+    sed -E "s/^(let STEPS *= *)[0-9]+/\1$STEPS/; s/^(while \(i < )5\)/\1${STEPS}000)/" \
+        "$ROOT/examples/$ex.nova" > "$src"
+    "$NOVAC" "$src" "$WORK/$ex.nvc"
+    "$NOVAC" --regs "$src" "$WORK/$ex.r.nvc"
+    a=$(best_ms "$NOVAVM" "$WORK/$ex.nvc")
+    b=$(best_ms "$NOVAVM" "$WORK/$ex.r.nvc")
+    printf "%-18s %8sms %8sms %7sx %14s\n" "$ex" "$a" "$b" \
+        "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')" \
+        "$(wc -c < "$WORK/$ex.nvc")/$(wc -c < "$WORK/$ex.r.nvc")"
+done
+# Dispatch-Anzahl des Stack-Codes (Register-Code: ein Dispatch je Instruktion)
+"$NOVAVM" --ngrams=1 "$WORK/rule30.nvc" 2>&1 >/dev/null | sed -n 1p
@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+# Startlatenz von novavm: .nvc v1 (fread, Strings einzeln kopiert) gegen v2
+# (mmap, Strings/Code direkt aus dem Mapping). Die Programme enthalten ihren
+# ganzen Code in einem nie betretenen if-Block; gemessen wird also Laden +
+# Übersetzen + Exit. Zielgrößen in Bytes, Default 1 KB .. 100 MB.
+#
+#   bench/startup.sh [runs] [sizes...]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+RUNS="${1:-5}"; shift || true
+SIZES=("$@")
+[ ${#SIZES[@]} -gt 0 ] || SIZES=(1000 100000 1000000 10000000 100000000)
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$WORK/build" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$WORK/build" >/dev/null 2>&1
+NOVAC="$WORK/build/novac"; NOVAVM="$WORK/build/novavm"
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local us=$(( (t1 - t0) / 1000 ))
+        if [ -z "$best" ] || [ "$us" -lt "$best" ]; then best=$us; fi
+    done
+    awk -v us="$best" 'BEGIN{ printf "%.2f", us/1000 }'
+}
+
+# ~48 Byte Bytecode je Zeile, alle 64 Zeilen ein String (max. 4000 Strings)
+gen() {
+    awk -v lines="$(( $1 / 48 + 1 ))" 'BEGIN{
+        print "let off = 0"; print "let x = 1"; print "let y = 2"; print "let z = 3"
+        print "if (off) {"
+        for(i = 0; i < lines; i++){
+            if(i % 64 == 0 && i / 64 < 4000) printf "  println(\"string %d padding padding padding padding\")\n", i / 64
+            else printf "  x = x * %d + y * %d - z / %d + %d\n", i % 97 + 2, i % 89 + 2, i % 83 + 2, i
+        }
+        print "}"; print "println(x)"
+    }'
+}
+
+printf "%12s %12s %10s %10s %8s\n" "target" "nvc bytes" "v1" "v2" "speedup"
+for size in "${SIZES[@]}"; do
+    gen "$size" > "$WORK/p.nova"
+    "$NOVAC" --format=v1 "$WORK/p.nova" "$WORK/p1.nvc"
+    "$NOVAC" --format=v2 "$WORK/p.nova" "$WORK/p2.nvc"
+    a=$(best_ms "$NOVAVM" "$WORK/p1.nvc")
+    b=$(best_ms "$NOVAVM" "$WORK/p2.nvc")
+    printf "%12s %12s %8sms %8sms %7sx\n" "$size" "$(stat -c %s "$WORK/p2.nvc")" "$a" "$b" \
+        "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')"
+done
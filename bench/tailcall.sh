@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# Summe 1..N dreimal: while-Schleife, endrekursive Funktion (TAILCALL,
+# konstanter Stackplatz) und eine nicht endrekursive Funktion in Ketten von
+# je 100 Aufrufen (CALL/RET). N ein Vielfaches von 100, bester von RUNS Läufen.
+#
+#   bench/tailcall.sh [n] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+N="${1:-10000000}"
+RUNS="${2:-5}"
+WORK="$(mktemp -d)"
+BUILD="$WORK/build"
+trap 'rm -rf "$WORK"' EXIT
+
+cmake -S "$ROOT" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+cmake --build "$BUILD" >/dev/null 2>&1
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+cat > "$WORK/loop.nova" <<NOVA
+let s = 0
+let i = $N
+while (i > 0) {
+  s = s + i
+  i = i - 1
+}
+println(s)
+NOVA
+cat > "$WORK/tail.nova" <<NOVA
+func sum_to(n, acc){
+  if (n == 0) { return acc }
+  return sum_to(n - 1, acc + n)
+}
+println(sum_to($N, 0))
+NOVA
+# Ergebnis erst in r ablegen: keine Endrekursion, Ketten der Tiefe 100
+cat > "$WORK/call.nova" <<NOVA
+func sum_down(n, stop, acc){
+  if (n == stop) { return acc }
+  let r = sum_down(n - 1, stop, acc + n)
+  return r
+}
+let s = 0
+let i = $N
+while (i > 0) {
+  s = sum_down(i, i - 100, s)
+  i = i - 100
+}
+println(s)
+NOVA
+
+for v in loop tail call; do "$BUILD/novac" "$WORK/$v.nova" "$WORK/$v.nvc"; done
+ref=$("$BUILD/novavm" "$WORK/loop.nvc")
+for v in tail call; do
+    [ "$("$BUILD/novavm" "$WORK/$v.nvc")" = "$ref" ] || echo "warning: $v output differs" >&2
+done
+
+printf "%-8s %10s %10s %10s\n" "engine" "while" "tailcall" "call/ret"
+for jit in off on; do
+    t=()
+    for v in loop tail call; do t+=("$(best_ms "$BUILD/novavm" --jit=$jit "$WORK/$v.nvc")"); done
+    printf "%-8s %8sms %8sms %8sms\n" "$jit" "${t[0]}" "${t[1]}" "${t[2]}"
+done
@@ -0,0 +1,76 @@
+#!/usr/bin/env bash
+# Mikrobenchmarks für die Wertdarstellung: reine Integer-Schleifen mit der
+# aktuellen VM gegen eine Vergleichsrevision (Default HEAD~1), jeweils
+# interpretiert und mit --jit=on. Beide Stände übersetzen die Programme
+# mit ihrem eigenen novac.
+#
+#   bench/values.sh [base-rev] [n] [runs]
+set -euo pipefail
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+BASE="${1:-HEAD~1}"
+N="${2:-3000000}"
+RUNS="${3:-5}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$WORK/base-src"
+git -C "$ROOT" archive "$BASE" | tar -x -C "$WORK/base-src"
+for t in base:"$WORK/base-src" cur:"$ROOT"; do
+    cmake -S "${t#*:}" -B "$WORK/${t%%:*}" -DCMAKE_BUILD_TYPE=Release -DBUILD_TESTING=OFF >/dev/null
+    cmake --build "$WORK/${t%%:*}" >/dev/null 2>&1
+done
+
+best_ms() {
+    local best=""
+    for _ in $(seq "$RUNS"); do
+        local t0 t1
+        t0=$(date +%s%N); "$@" >/dev/null; t1=$(date +%s%N)
+        local ms=$(( (t1 - t0) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+# Zähl-/Akkumulatorschleife, Vergleichskette, Funktionsaufrufe mit Locals
+cat > "$WORK/arith.nova" <<NOVA
+let s = 0
+let i = 0
+while (i < $N) {
+  s = (s + i * 3 - i / 7) % 1000003
+  i = i + 1
+}
+println(s)
+NOVA
+cat > "$WORK/compare.nova" <<NOVA
+let c = 0
+let i = 0
+while (i < $N) {
+  if (i % 3 == 0) { c = c + 1 } else { if (i % 5 < 2) { c = c - 1 } }
+  i = i + 1
+}
+println(c)
+NOVA
+cat > "$WORK/calls.nova" <<NOVA
+func step(x, k){
+  let y = x * 5 + k
+  return y % 65521
+}
+let h = 1
+let i = 0
+while (i < $N) {
+  h = step(h, i)
+  i = i + 1
+}
+println(h)
+NOVA
+
+printf "%-10s %-6s %10s %10s %8s\n" "program" "engine" "$BASE" "current" "ratio"
+for p in arith compare calls; do
+    for t in base cur; do "$WORK/$t/novac" "$WORK/$p.nova" "$WORK/$p.$t.nvc"; done
+    for jit in off on; do
+        a=$(best_ms "$WORK/base/novavm" --jit=$jit "$WORK/$p.base.nvc")
+        b=$(best_ms "$WORK/cur/novavm" --jit=$jit "$WORK/$p.cur.nvc")
+        printf "%-10s %-6s %8sms %8sms %7sx\n" "$p" "$jit" "$a" "$b" \
+            "$(awk -v a="$a" -v b="$b" 'BEGIN{ printf "%.2f", (b>0)?a/b:0 }')"
+    done
+done
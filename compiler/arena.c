@@ -0,0 +1,105 @@
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_CHUNK (256u << 10)
+#define ARENA_BIG   (ARENA_CHUNK / 4)  // ab hier bekommt eine Anforderung einen eigenen Chunk
+#define ARENA_ALIGN 16
+
+struct ArenaChunk { ArenaChunk* prev; size_t size; };
+#define CHUNK_HDR ((sizeof(ArenaChunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+static size_t align_up(size_t n){ return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1); }
+
+static void oom(Arena* a){
+    if(a->diag) diag_fail(a->diag, 0, "out of memory");
+    fprintf(stderr, "error: out of memory\n");
+    exit(1);
+}
+
+static ArenaChunk* chunk(Arena* a, size_t size){
+    if(size == ARENA_CHUNK && a->spare){
+        ArenaChunk* c = a->spare;
+        a->spare = c->prev;
+        return c;
+    }
+    ArenaChunk* c = (ArenaChunk*)malloc(CHUNK_HDR + size);
+    if(!c) oom(a);
+    c->size = size;
+    a->reserved += size;
+    return c;
+}
+
+void* arena_alloc(Arena* a, size_t n){
+    n = align_up(n ? n : 1);
+    a->used += n;
+    if(n > ARENA_BIG){
+        // eigener Chunk hinter dem aktuellen, dessen Rest bleibt nutzbar
+        ArenaChunk* c = chunk(a, n);
+        if(a->head){ c->prev = a->head->prev; a->head->prev = c; }
+        else { c->prev = NULL; a->head = c; a->cur = a->end = (char*)c + CHUNK_HDR + n; }
+        return (char*)c + CHUNK_HDR;
+    }
+    if((size_t)(a->end - a->cur) < n){
+        ArenaChunk* c = chunk(a, ARENA_CHUNK);
+        c->prev = a->head; a->head = c;
+        a->cur = (char*)c + CHUNK_HDR;
+        a->end = a->cur + ARENA_CHUNK;
+    }
+    void* p = a->cur;
+    a->cur += n;
+    return p;
+}
+
+void* arena_grow(Arena* a, void* p, size_t old, size_t n){
+    if(!p) return arena_alloc(a, n);
+    size_t o = align_up(old), m = align_up(n);
+    // jüngster Block im aktuellen Chunk: nur den Pointer verschieben
+    if((char*)p + o == a->cur && m >= o && (size_t)(a->end - (char*)p) >= m){
+        a->cur = (char*)p + m; a->used += m - o;
+        return p;
+    }
+    // Block mit eigenem Chunk: den Chunk selbst vergrößern (realloc)
+    if(o > ARENA_BIG && m > o){
+        ArenaChunk* c = (ArenaChunk*)((char*)p - CHUNK_HDR);
+        ArenaChunk** link = &a->head;
+        while(*link && *link != c) link = &(*link)->prev;
+        if(*link && c != a->head){
+            ArenaChunk* r = (ArenaChunk*)realloc(c, CHUNK_HDR + m);
+            if(!r) oom(a);
+            *link = r;
+            r->size = m; a->reserved += m - o; a->used += m - o;
+            return (char*)r + CHUNK_HDR;
+        }
+    }
+    void* q = arena_alloc(a, n);
+    memcpy(q, p, old < n ? old : n);
+    return q;
+}
+
+char* arena_strndup(Arena* a, const char* s, size_t len){
+    char* d = (char*)arena_alloc(a, len + 1);
+    memcpy(d, s, len); d[len] = 0;
+    return d;
+}
+
+void arena_reset(Arena* a){
+    // Chunks normaler Größe auf die Reserve, eigene Chunks großer Blöcke freigeben
+    for(ArenaChunk* c = a->head; c; ){
+        ArenaChunk* prev = c->prev;
+        if(c->size == ARENA_CHUNK){ c->prev = a->spare; a->spare = c; }
+        else { a->reserved -= c->size; free(c); }
+        c = prev;
+    }
+    a->head = NULL; a->cur = a->end = NULL;
+    a->used = 0;
+}
+
+void arena_free(Arena* a){
+    arena_reset(a);
+    for(ArenaChunk* c = a->spare; c; ){ ArenaChunk* prev = c->prev; free(c); c = prev; }
+    Diag* d = a->diag;
+    memset(a, 0, sizeof(*a));
+    a->diag = d;
+}
@@ -0,0 +1,30 @@
+#ifndef NOVA_ARENA_H
+#define NOVA_ARENA_H
+#include <stddef.h>
+
+// Bump-Pointer-Arena für die Daten einer Übersetzung (Quelltext, Namen,
+// Symboltabelle, Env). Einzelne Blöcke werden nie freigegeben; arena_free
+// gibt alles auf einmal zurück. Eine mit {0} initialisierte Arena ist leer
+// und gültig. Bei Speichermangel springt sie über diag zurück (diag.h),
+// ohne diag bricht sie ab. arena_reset gibt alles frei, behält aber die
+// Chunks für die nächste Übersetzung (kein erneutes malloc).
+#include "diag.h"
+
+typedef struct ArenaChunk ArenaChunk;
+typedef struct {
+    ArenaChunk* head;      // aktueller Chunk (Liste rückwärts)
+    char*  cur;            // nächstes freies Byte im aktuellen Chunk
+    char*  end;
+    size_t used;           // angeforderte Bytes insgesamt (Statistik)
+    size_t reserved;       // Summe der Chunkgrößen
+    ArenaChunk* spare;     // nach arena_reset frei gewordene Chunks
+    Diag*  diag;           // Ziel bei Speichermangel, NULL = exit
+} Arena;
+
+void* arena_alloc(Arena* a, size_t n);                 // 16-Byte-ausgerichtet, nicht genullt
+void* arena_grow(Arena* a, void* p, size_t old, size_t n); // wie realloc; der jüngste Block wächst an Ort und Stelle
+char* arena_strndup(Arena* a, const char* s, size_t len);  // NUL-terminierte Kopie
+void  arena_reset(Arena* a);                          // alles verwerfen, Chunks behalten
+void  arena_free(Arena* a);
+
+#endif
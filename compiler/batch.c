@@ -0,0 +1,387 @@
+// novac --batch: viele Quellen auf einem Thread-Pool übersetzen.
+//
+// Jeder Worker hat seinen eigenen NovaCompiler (libnovac, wiederverwendet) und
+// holt sich die nächste Datei aus einer gemeinsamen Liste. Vor dem Übersetzen
+// wird im Cache nachgesehen: der Schlüssel ist ein 128-Bit-Hash über die
+// novac-Binärdatei selbst (jede neu gebaute novac verwirft den Cache), die
+// Optionen und den Quelltext. Ein Treffer liefert das Image samt der
+// Warnungen der ursprünglichen Übersetzung, ohne Lexer und Codegenerierung.
+//
+// Cache-Eintrag <cache>/<key>.nvcc: "NOVACC01", u32 Länge der Warnungen,
+// u32 Länge des Images, Warnungen (Text), Image. Geschrieben wird über eine
+// temporäre Datei und rename, parallele novac-Läufe sehen also nie halbe Einträge.
+#include "batch.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC "NOVACC01"
+#define CACHE_HDR   16
+
+enum { F_ERROR, F_HIT, F_BUILT };
+static const char* const status_name[] = { "error", "hit", "built" };
+
+typedef struct {
+    char*  src;            // Pfad der Quelle
+    const char* rel;       // relativ zum Eingabeverzeichnis (zeigt in src)
+    char*  out;            // Pfad des .nvc
+    int    status;
+    double ms;
+    char*  msgs; size_t msgs_len, msgs_cap; // Warnungen/Fehler, Zeile für Zeile
+} File;
+
+typedef struct { uint64_t a, b; } Key;
+
+typedef struct {
+    const BatchOptions* b;
+    NovaOptions o;
+    const char* cache;
+    Key base;              // Schlüssel über Compiler und Optionen
+    File* files; int nfiles, capfiles;
+    int next;              // nächste freie Datei
+    pthread_mutex_t lock;
+} Batch;
+
+typedef struct { Batch* B; int id; File* cur; } Worker;
+
+static double now_ms(void){
+    struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e3 + (double)t.tv_nsec * 1e-6;
+}
+
+static void* xmalloc(size_t n){
+    void* p = malloc(n ? n : 1);
+    if(!p){ fprintf(stderr, "error: out of memory\n"); exit(1); }
+    return p;
+}
+
+static char* path_join(const char* a, const char* b){
+    size_t la = strlen(a), lb = strlen(b);
+    char* s = (char*)xmalloc(la + lb + 2);
+    memcpy(s, a, la);
+    size_t n = la;
+    if(n && s[n-1] != '/') s[n++] = '/';
+    memcpy(s + n, b, lb + 1);
+    return s;
+}
+
+// len Bytes anhängen; msgs bleibt NUL-terminiert
+static void msg_append(File* f, const char* data, size_t len){
+    if(f->msgs_len + len + 1 > f->msgs_cap){
+        f->msgs_cap = (f->msgs_len + len + 1) * 2;
+        char* p = (char*)realloc(f->msgs, f->msgs_cap);
+        if(!p){ fprintf(stderr, "error: out of memory\n"); exit(1); }
+        f->msgs = p;
+    }
+    memcpy(f->msgs + f->msgs_len, data, len);
+    f->msgs_len += len;
+    f->msgs[f->msgs_len] = 0;
+}
+
+static void msg_add(File* f, const char* fmt, ...){
+    char m[512];
+    va_list ap; va_start(ap, fmt);
+    int n = vsnprintf(m, sizeof(m), fmt, ap);
+    va_end(ap);
+    if(n < 0) return;
+    if((size_t)n < sizeof(m)){ msg_append(f, m, (size_t)n); return; }
+    // länger als der Puffer: direkt in der passenden Größe formatieren
+    char* big = (char*)xmalloc((size_t)n + 1);
+    va_start(ap, fmt);
+    vsnprintf(big, (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    msg_append(f, big, (size_t)n);
+    free(big);
+}
+
+static void on_warning(void* user, int line, const char* msg){
+    File* f = ((Worker*)user)->cur;
+    if(line) msg_add(f, "warning: line %d: %s\n", line, msg);
+    else     msg_add(f, "warning: %s\n", msg);
+}
+
+// ganze Datei lesen; NULL wenn nicht lesbar
+static char* read_all(const char* path, size_t* len){
+    FILE* f = fopen(path, "rb");
+    if(!f) return NULL;
+    char* buf = NULL; size_t n = 0, cap = 0, r;
+    do {
+        if(n == cap){
+            cap = cap ? cap * 2 : 64 << 10;
+            char* p = (char*)realloc(buf, cap);
+            if(!p){ free(buf); fclose(f); return NULL; }
+            buf = p;
+        }
+        r = fread(buf + n, 1, cap - n, f);
+        n += r;
+    } while(r > 0);
+    int err = ferror(f);
+    fclose(f);
+    if(err){ free(buf); return NULL; }
+    *len = n;
+    return buf ? buf : (char*)xmalloc(1);
+}
+
+static int write_all(const char* path, const void* a, size_t na, const void* b, size_t nb){
+    FILE* f = fopen(path, "wb");
+    if(!f) return 0;
+    int ok = fwrite(a, 1, na, f) == na && (nb == 0 || fwrite(b, 1, nb, f) == nb);
+    if(fclose(f) != 0) ok = 0;
+    if(!ok) remove(path);
+    return ok;
+}
+
+// Verzeichnis samt Eltern anlegen (mkdir -p)
+static int mkdir_p(const char* path){
+    char* p = path_join(path, "");
+    for(char* s = p + 1; *s; s++){
+        if(*s != '/') continue;
+        *s = 0;
+        if(mkdir(p, 0777) != 0 && errno != EEXIST){ free(p); return 0; }
+        *s = '/';
+    }
+    free(p);
+    return 1;
+}
+
+// ---- Cache-Schlüssel: zwei FNV-1a-64 mit verschiedenen Startwerten ----
+static void key_add(Key* k, const void* p, size_t n){
+    const unsigned char* c = (const unsigned char*)p;
+    uint64_t a = k->a, b = k->b;
+    for(size_t i = 0; i < n; i++){
+        a = (a ^ c[i]) * 1099511628211u;
+        b = (b ^ c[i]) * 1099511628211u;
+    }
+    k->a = a; k->b = b;
+}
+
+static void key_base(Batch* B){
+    Key* k = &B->base;
+    k->a = 14695981039346656037u; k->b = 0x6a09e667f3bcc908u;
+    size_t n;
+    char* exe = read_all("/proc/self/exe", &n);
+    if(exe){ key_add(k, exe, n); free(exe); }
+    else key_add(k, __DATE__ " " __TIME__, sizeof(__DATE__ " " __TIME__));
+    int32_t flags[5] = { B->o.opt, B->o.regs, B->o.checked, B->o.format, B->o.strip };
+    key_add(k, flags, sizeof(flags));
+}
+
+static char* cache_path(const Batch* B, const Key* k, const char* suffix){
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx%016llx%s", (unsigned long long)k->a, (unsigned long long)k->b, suffix);
+    return path_join(B->cache, name);
+}
+
+static uint32_t rd32(const char* p){
+    const unsigned char* u = (const unsigned char*)p;
+    return (uint32_t)u[0] | (uint32_t)u[1] << 8 | (uint32_t)u[2] << 16 | (uint32_t)u[3] << 24;
+}
+static void wr32(char* p, uint32_t v){
+    for(int i = 0; i < 4; i++) p[i] = (char)(v >> (8*i));
+}
+
+// ---- Eingaben sammeln ----
+static void add_file(Batch* B, char* src, size_t dirlen){
+    if(B->nfiles == B->capfiles){
+        B->capfiles = B->capfiles ? B->capfiles * 2 : 64;
+        File* p = (File*)realloc(B->files, (size_t)B->capfiles * sizeof(File));
+        if(!p){ fprintf(stderr, "error: out of memory\n"); exit(1); }
+        B->files = p;
+    }
+    File* f = &B->files[B->nfiles++];
+    memset(f, 0, sizeof(*f));
+    f->src = src;
+    f->rel = src + dirlen;
+    while(*f->rel == '/') f->rel++;
+}
+
+// rekursiv; Einträge mit '.' am Anfang (auch der Cache) werden übergangen
+static void walk(Batch* B, const char* dir, size_t dirlen){
+    DIR* d = opendir(dir);
+    if(!d) return;
+    struct dirent* e;
+    while((e = readdir(d)) != NULL){
+        if(e->d_name[0] == '.') continue;
+        char* p = path_join(dir, e->d_name);
+        struct stat st;
+        size_t n = strlen(e->d_name);
+        if(stat(p, &st) != 0) free(p);
+        else if(S_ISDIR(st.st_mode)){ walk(B, p, dirlen); free(p); }
+        else if(S_ISREG(st.st_mode) && n > 5 && strcmp(e->d_name + n - 5, ".nova") == 0) add_file(B, p, dirlen);
+        else free(p);
+    }
+    closedir(d);
+}
+
+static int by_path(const void* a, const void* b){ return strcmp(((const File*)a)->src, ((const File*)b)->src); }
+
+static char* out_path(const Batch* B, const File* f){
+    const char* base = B->b->out_dir ? B->b->out_dir : B->b->dir;
+    char* p = path_join(base, f->rel);
+    strcpy(p + strlen(p) - 5, ".nvc");
+    return p;
+}
+
+// .nvc schreiben, außer die Datei hat schon genau diesen Inhalt (mtime bleibt)
+static int write_output(File* f, const uint8_t* img, size_t len){
+    size_t n;
+    char* old = read_all(f->out, &n);
+    int same = old && n == len && memcmp(old, img, len) == 0;
+    free(old);
+    if(same) return 1;
+    char* slash = strrchr(f->out, '/');
+    if(slash){ *slash = 0; int ok = mkdir_p(f->out); *slash = '/'; if(!ok) return 0; }
+    return write_all(f->out, img, len, NULL, 0);
+}
+
+// ---- eine Datei ----
+static void process(Worker* w, NovaCompiler* c, NovaBytecode* bc, File* f){
+    Batch* B = w->B;
+    double t0 = now_ms();
+    f->status = F_ERROR;
+    size_t len;
+    char* src = read_all(f->src, &len);
+    if(!src){ msg_add(f, "error: cannot read\n"); f->ms = now_ms() - t0; return; }
+
+    char* cpath = NULL;
+    char* entry = NULL; size_t elen = 0;
+    const uint8_t* img = NULL; size_t ilen = 0;
+    if(B->cache){
+        Key k = B->base;
+        uint64_t l = len;
+        key_add(&k, &l, sizeof(l));
+        key_add(&k, src, len);
+        cpath = cache_path(B, &k, ".nvcc");
+        entry = read_all(cpath, &elen);
+        if(entry && elen >= CACHE_HDR && memcmp(entry, CACHE_MAGIC, 8) == 0 &&
+           (uint64_t)CACHE_HDR + rd32(entry + 8) + rd32(entry + 12) == elen){
+            uint32_t wl = rd32(entry + 8);
+            if(wl) msg_append(f, entry + CACHE_HDR, wl);
+            img = (const uint8_t*)entry + CACHE_HDR + wl;
+            ilen = rd32(entry + 12);
+            f->status = F_HIT;
+        }
+    }
+    if(!img){
+        NovaDiag d;
+        w->cur = f;
+        if(!nova_compiler_compile(c, src, len, bc, &d)){
+            if(d.line) msg_add(f, "error: line %d: %s\n", d.line, d.msg);
+            else       msg_add(f, "error: %s\n", d.msg);
+            goto done;
+        }
+        img = bc->data; ilen = bc->len;
+        f->status = F_BUILT;
+        if(cpath && ilen <= UINT32_MAX){
+            // Eintrag = Kopf + Warnungen dieser Übersetzung + Image
+            char hdr[CACHE_HDR];
+            size_t wl = f->msgs_len;
+            char sfx[48]; snprintf(sfx, sizeof(sfx), ".tmp%ld.%d", (long)getpid(), w->id);
+            char* tmp = (char*)xmalloc(strlen(cpath) + strlen(sfx) + 1);
+            strcpy(tmp, cpath); strcat(tmp, sfx);
+            char* body = (char*)xmalloc(wl + ilen);
+            if(wl) memcpy(body, f->msgs, wl);
+            memcpy(body + wl, img, ilen);
+            memcpy(hdr, CACHE_MAGIC, 8); wr32(hdr + 8, (uint32_t)wl); wr32(hdr + 12, (uint32_t)ilen);
+            if(write_all(tmp, hdr, CACHE_HDR, body, wl + ilen) && rename(tmp, cpath) != 0) remove(tmp);
+            free(body); free(tmp);
+        }
+    }
+    if(!write_output(f, img, ilen)){ msg_add(f, "error: cannot write %s\n", f->out); f->status = F_ERROR; }
+done:
+    free(entry); free(cpath); free(src);
+    f->ms = now_ms() - t0;
+}
+
+static void* worker(void* arg){
+    Worker* w = (Worker*)arg;
+    Batch* B = w->B;
+    NovaOptions o = B->o;
+    o.warn = on_warning; o.user = w;
+    NovaCompiler* c = nova_compiler_new(&o);
+    NovaBytecode bc = {0};
+    if(!c){ fprintf(stderr, "error: out of memory\n"); exit(1); }
+    for(;;){
+        pthread_mutex_lock(&B->lock);
+        int i = B->next < B->nfiles ? B->next++ : -1;
+        pthread_mutex_unlock(&B->lock);
+        if(i < 0) break;
+        process(w, c, &bc, &B->files[i]);
+    }
+    nova_bytecode_free(&bc);
+    nova_compiler_free(c);
+    return NULL;
+}
+
+int batch_main(const BatchOptions* b, const NovaOptions* o){
+    Batch B;
+    memset(&B, 0, sizeof(B));
+    B.b = b; B.o = *o;
+    pthread_mutex_init(&B.lock, NULL);
+    double t0 = now_ms();
+
+    struct stat st;
+    if(stat(b->dir, &st) != 0 || !S_ISDIR(st.st_mode)){ fprintf(stderr, "novac --batch: %s: not a directory\n", b->dir); return 1; }
+    walk(&B, b->dir, strlen(b->dir));
+    qsort(B.files, (size_t)B.nfiles, sizeof(File), by_path);
+    for(int i = 0; i < B.nfiles; i++) B.files[i].out = out_path(&B, &B.files[i]);
+
+    char* cache = NULL;
+    if(!b->no_cache){
+        cache = b->cache_dir ? path_join(b->cache_dir, "") : path_join(b->dir, ".novac-cache");
+        if(!mkdir_p(cache)){
+            fprintf(stderr, "warning: --batch: cannot create cache %s, compiling without\n", cache);
+            free(cache); cache = NULL;
+        }
+        else key_base(&B);
+    }
+    B.cache = cache;
+
+    int jobs = b->jobs > 0 ? b->jobs : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(jobs < 1) jobs = 1;
+    if(jobs > 256) jobs = 256;
+    if(jobs > B.nfiles) jobs = B.nfiles ? B.nfiles : 1;
+    Worker* ws = (Worker*)xmalloc((size_t)jobs * sizeof(Worker));
+    pthread_t* th = (pthread_t*)xmalloc((size_t)jobs * sizeof(pthread_t));
+    int started = 0;
+    for(int i = 0; i < jobs; i++){
+        ws[i].B = &B; ws[i].id = i; ws[i].cur = NULL;
+        if(i > 0 && pthread_create(&th[i], NULL, worker, &ws[i]) != 0) break;
+        started = i + 1;
+    }
+    worker(&ws[0]);                 // der Hauptthread arbeitet mit
+    for(int i = 1; i < started; i++) pthread_join(th[i], NULL);
+    double total = now_ms() - t0;
+
+    // Bericht in Pfadreihenfolge: Diagnosen nach stderr, Zeiten nach stdout
+    int hits = 0, built = 0, errors = 0;
+    for(int i = 0; i < B.nfiles; i++){
+        File* f = &B.files[i];
+        if(f->status == F_HIT) hits++;
+        else if(f->status == F_BUILT) built++;
+        else errors++;
+        for(char* m = f->msgs; m && *m; ){
+            char* nl = strchr(m, '\n');
+            int n = nl ? (int)(nl - m) : (int)strlen(m);
+            fprintf(stderr, "%s: %.*s\n", f->rel, n, m);
+            m += n + (nl != NULL);
+        }
+        printf("  %-6s %9.2f ms  %s\n", status_name[f->status], f->ms, f->rel);
+    }
+    printf("novac --batch: %d files, %d cache hits (%.1f%%), %d compiled, %d failed, %d threads, %.1f ms\n",
+           B.nfiles, hits, B.nfiles ? 100.0 * hits / B.nfiles : 0.0, built, errors, started, total);
+
+    for(int i = 0; i < B.nfiles; i++){ free(B.files[i].src); free(B.files[i].out); free(B.files[i].msgs); }
+    free(B.files); free(ws); free(th); free(cache);
+    pthread_mutex_destroy(&B.lock);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,18 @@
+#ifndef NOVA_BATCH_H
+#define NOVA_BATCH_H
+// novac --batch: alle .nova-Dateien unter einem Verzeichnis auf einem
+// Thread-Pool übersetzen, mit Cache auf der Platte (batch.c)
+#include "novac.h"
+
+typedef struct {
+    const char* dir;        // Eingabeverzeichnis (rekursiv)
+    const char* out_dir;    // NULL = .nvc neben die Quelle
+    const char* cache_dir;  // NULL = <dir>/.novac-cache
+    int jobs;               // Threads, 0 = Anzahl CPUs
+    int no_cache;
+} BatchOptions;
+
+// Liefert den Exit-Code von novac (0 = alles übersetzt)
+int batch_main(const BatchOptions* b, const NovaOptions* o);
+
+#endif
@@ -0,0 +1,1253 @@
+
+// libnovac - minimal compiler with string support (API: novac.h, CLI: novac.c)
+// Bytecode format: vm/nvc.h (v2 "NOVABC02" mit Sektions-Offsets, Default;
+// --format=v1 schreibt das alte sequentielle "NOVABC01")
+// --regs: Magic "NOVARC0x", Registercode statt Stack-Bytecode
+// Variables: globals in VM slots (no fixed cap), function parameters and locals in
+// per-function frames (NOVA_MAX_SLOTS = 256 per function). Values are 64-bit tagged
+// (vm/value.h). Strings live in constant pool; VM prints strings/ints.
+//
+// Language subset:
+//  program := { stmt }
+//  stmt    := "let" ident "=" expr | ident "=" expr | "print" "(" expr ")" | "println" "(" expr ")" | if | while | "{" { stmt } "}"
+//  if      := "if" "(" expr ")" block [ "else" block ]
+//  while   := "while" "(" expr ")" block
+//  expr    := precedence climbing over ||, &&, comparisons, + - * / %, unary - !
+//  primary := number | string | ident | "(" expr ")"
+//
+// No semicolons; newlines and braces separate statements.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "novac.h"
+#include "emit.h"
+#include "diag.h"
+#include "symtab.h"
+#include "intern.h"
+#include "arena.h"
+#include "lexer.h"
+#include "opcodes.h"
+#include "nvc.h"
+#include "value.h"
+#include "regalloc.h"
+#include "peephole.h"
+
+#define MAX_CODE  (1<<20)
+
+// --------- Parser / Emitter ---------
+
+// Namen sind interned ids (intern.h); Env indiziert damit direkt.
+typedef struct {
+    int  name;      // interned id
+    int  arity;     // Anzahl Parameter
+    int  addr;      // Code-Offset (Ziel für CALL); -1 = von -O2 entfernt (nie aufgerufen)
+    int  next;      // nächste Funktion gleichen Namens (andere Arity), -1
+} Func;
+
+// Alle Tabellen liegen in der Arena der Übersetzung (wachsen per arena_grow).
+typedef struct {
+    Arena* arena;
+    Intern* names;                             // interned Namen und Stringtexte
+    int* var_slot; int var_cap; int nvars;     // name -> globaler Slot, -1
+    int* str_slot; int str_cap;                // interned Text -> Pool-Index, -1
+    char* strblob; uint32_t blob_len, blob_cap; // Pool: alle Strings NUL-terminiert
+    uint32_t* stroff; int nstrs, capstrs;      // Pool-Index -> Offset im Blob
+    Func* funcs; int nfuncs, capfuncs;
+    int* func_head; int func_cap;              // name -> erste Funktion, -1
+} Env;
+
+// Array in der Arena von cap auf ncap Elemente der Größe sz bringen
+#define GROW(E, p, cap, ncap) ((p) = arena_grow((E)->arena, (p), (size_t)(cap) * sizeof(*(p)), (size_t)(ncap) * sizeof(*(p))))
+// Tabelle name -> int auf mindestens n Einträge bringen (neue = -1)
+static int* grow_map(Env* E, int* map, int* cap, int n){
+    if(n < *cap) return map;
+    int ncap = *cap ? *cap : 256;
+    while(ncap <= n) ncap *= 2;
+    GROW(E, map, *cap, ncap);
+    for(int i=*cap;i<ncap;i++) map[i] = -1;
+    *cap = ncap;
+    return map;
+}
+
+static int env_find_func(Env* E, int name, int arity){
+    if(name >= E->func_cap) return -1;
+    for(int i=E->func_head[name]; i>=0; i=E->funcs[i].next)
+        if(E->funcs[i].arity==arity) return i;
+    return -1;
+}
+static int env_add_func(Env* E, int name, int arity, int addr){
+    E->func_head = grow_map(E, E->func_head, &E->func_cap, name);
+    if(E->nfuncs == E->capfuncs){
+        int ncap = E->capfuncs ? E->capfuncs*2 : 64;
+        GROW(E, E->funcs, E->capfuncs, ncap);
+        E->capfuncs = ncap;
+    }
+    int id = E->nfuncs++;
+    E->funcs[id].name  = name;
+    E->funcs[id].arity = arity;
+    E->funcs[id].addr  = addr;
+    E->funcs[id].next  = E->func_head[name];
+    E->func_head[name] = id;
+    return id;
+}
+
+static int env_find_var(Env* E, int name){
+    return name < E->var_cap ? E->var_slot[name] : -1;
+}
+// let auf oberster Ebene: erneutes let desselben Namens nutzt denselben Slot
+static int env_add_var(Env* E, int name){
+    E->var_slot = grow_map(E, E->var_slot, &E->var_cap, name);
+    if(E->var_slot[name] < 0) E->var_slot[name] = E->nvars++;
+    return E->var_slot[name];
+}
+// String-Literal in den Pool; gleicher Text -> gleicher Index (über intern)
+static int env_add_string(Env* E, const char* s, size_t len){
+    int id = intern(E->names, s, len);
+    E->str_slot = grow_map(E, E->str_slot, &E->str_cap, id);
+    if(E->str_slot[id] >= 0) return E->str_slot[id];
+    if(E->nstrs == E->capstrs){
+        int ncap = E->capstrs ? E->capstrs*2 : 64;
+        GROW(E, E->stroff, E->capstrs, ncap);
+        E->capstrs = ncap;
+    }
+    if(E->blob_len + len + 1 > E->blob_cap){
+        uint32_t ncap = E->blob_cap ? E->blob_cap : 1024;
+        while(E->blob_len + len + 1 > ncap) ncap *= 2;
+        GROW(E, E->strblob, E->blob_cap, ncap);
+        E->blob_cap = ncap;
+    }
+    E->stroff[E->nstrs] = E->blob_len;
+    memcpy(E->strblob + E->blob_len, s, len);
+    E->strblob[E->blob_len + len] = 0;
+    E->blob_len += (uint32_t)len + 1;
+    E->str_slot[id] = E->nstrs;
+    return E->nstrs++;
+}
+
+// forward decls
+#define NTAIL 5
+typedef struct {
+    Lexer* L; Token t; CodeBuf* out; Env* env; SymTab* sym;
+    int in_func;               // 1 = Funktionsrumpf: Namen zuerst in der Symboltabelle (Locals)
+    size_t tail[NTAIL]; int ntail; // Startoffsets der letzten Instruktionen seit dem letzten Label
+    int op_line;               // Zeile des zuletzt gelesenen Operators (Diagnosen der Faltung)
+    int opt;                   // -O: 0 = wörtlich, 1 = Faltung/Fusion beim Emittieren, 2 = + Peephole
+    int checked;               // --checked: ADD/SUB/MUL als *_CHK (Überlauf bricht ab)
+    int loop_depth;            // Schachtelungstiefe von while
+    struct Bce* bce;           // Kandidaten der Bounds-Check-Elimination (innerste zuerst)
+    NovaWarnFn warn; void* user; // Warnungen (NovaOptions)
+    LineBuf* lines;            // Zeilentabelle (Debug-Sektion)
+} P;
+
+typedef struct Bce {
+    struct Bce* outer;
+    int iop, islot, aop, aslot;  // LOAD/LOAD_LOCAL und Slot von i und a
+    int depth;                   // loop_depth im Rumpf der Schleife
+    int i_dirty;                 // i im Rumpf bereits erhöht
+    int invalid;
+    size_t* sites; int nsites, cap; // Offsets der ALOAD/ASTORE-Opcodes
+} Bce;
+static void parse_stmt(P* p);
+static void parse_block(P* p);
+static void parse_expr(P* p);
+
+static void next(P* p){ p->t = lx_next(p->L); }
+static int accept(P* p, TokKind k){ if(p->t.kind==k){ next(p); return 1; } return 0; }
+static void expect(P* p, TokKind k, const char* msg){ if(!accept(p,k)) die_at(p->L, msg); }
+
+// Emitter helpers
+static void emit(P* p, uint8_t op){
+    memmove(p->tail, p->tail + 1, (NTAIL-1) * sizeof(size_t));
+    p->tail[NTAIL-1] = p->out->len;
+    if(p->ntail < NTAIL) p->ntail++;
+    cb_w8(p->out, op);
+}
+static void emit32(P* p, int32_t v){ cb_w32(p->out, v); }
+
+// Sprungziel an der aktuellen Position: keine Fusion über diese Grenze
+static size_t mark_label(P* p){ p->ntail = 0; return p->out->len; }
+// Code ab hier gehört zur Quellzeile line
+static void line_mark(P* p, int line){ lb_mark(p->lines, p->out->len, line); }
+
+// ---- Superinstruktionen ----
+// Fusion direkt beim Emittieren: die letzten (bis zu NTAIL) Instruktionen seit
+// dem letzten Label werden gegen ein Muster geprüft und ggf. ersetzt. Da kein
+// Sprung in die Mitte zeigen kann, bleibt die Semantik erhalten.
+static int tail_op(P* p, int k){ // k=1: letzte Instruktion
+    return (k <= p->ntail) ? p->out->data[p->tail[NTAIL-k]] : -1;
+}
+static int32_t tail_arg(P* p, int k, int n){
+    int32_t v; memcpy(&v, p->out->data + p->tail[NTAIL-k] + 1 + 4*n, 4); return v;
+}
+static void tail_drop(P* p, int k){
+    p->out->len = p->tail[NTAIL-k];
+    p->ntail -= k;
+    memmove(p->tail + k, p->tail, (size_t)(NTAIL-k) * sizeof(size_t));
+}
+
+// Globale Slots (LOAD/STORE) und Locals (LOAD_LOCAL/STORE_LOCAL) haben je
+// eigene Varianten derselben Superinstruktionen.
+
+// ADD/SUB: LOAD s; PUSHI k; ADD  =>  LOAD_PUSHI_ADD s k
+static void emit_addsub(P* p, uint8_t op){
+    int ld = tail_op(p,2);
+    if(p->opt >= 1 && (ld==OP_LOAD || ld==OP_LOAD_LOCAL) && tail_op(p,1)==OP_PUSHI){
+        int32_t slot = tail_arg(p,2,0), k = tail_arg(p,1,0);
+        if(op==OP_ADD || k != INT32_MIN){
+            tail_drop(p, 2);
+            emit(p, ld==OP_LOAD ? OP_LOAD_PUSHI_ADD : OP_LOAD_LOCAL_PUSHI_ADD);
+            emit32(p, slot); emit32(p, op==OP_ADD ? k : -k);
+            return;
+        }
+    }
+    emit(p, op);
+}
+
+// STORE s nach LOAD_PUSHI_ADD s k  =>  INC_SLOT s k   (op: OP_STORE/OP_STORE_LOCAL)
+static void emit_store(P* p, uint8_t op, int slot){
+    int add = op==OP_STORE ? OP_LOAD_PUSHI_ADD : OP_LOAD_LOCAL_PUSHI_ADD;
+    if(p->opt >= 1 && tail_op(p,1)==add && tail_arg(p,1,0)==slot){
+        int32_t k = tail_arg(p,1,1);
+        tail_drop(p, 1);
+        emit(p, op==OP_STORE ? OP_INC_SLOT : OP_INC_LOCAL); emit32(p, slot); emit32(p, k);
+        return;
+    }
+    emit(p, op); emit32(p, slot);
+}
+
+// JZ mit Platzhalter; liefert die Position des Offsets (relativ zum
+// Instruktionsende, bei allen Varianten der letzte Operand).
+// LOAD a; LOAD b; LT; JZ  =>  LOAD_LOAD_LT_JZ a b off
+// LOAD i; LOAD a; ALEN; LT; JZ  =>  LOAD_LEN_LT_JZ i a off
+static size_t emit_jz(P* p){
+    int ld = tail_op(p,3), ldl = tail_op(p,4);
+    if(p->opt >= 1 && (ld==OP_LOAD || ld==OP_LOAD_LOCAL) && tail_op(p,2)==ld && tail_op(p,1)==OP_LT){
+        int32_t a = tail_arg(p,3,0), b = tail_arg(p,2,0);
+        tail_drop(p, 3);
+        emit(p, ld==OP_LOAD ? OP_LOAD_LOAD_LT_JZ : OP_LOCAL_LOCAL_LT_JZ); emit32(p, a); emit32(p, b);
+    } else if(p->opt >= 1 && (ldl==OP_LOAD || ldl==OP_LOAD_LOCAL) && tail_op(p,3)==ldl && tail_op(p,2)==OP_ALEN && tail_op(p,1)==OP_LT){
+        int32_t i = tail_arg(p,4,0), a = tail_arg(p,3,0);
+        tail_drop(p, 4);
+        emit(p, ldl==OP_LOAD ? OP_LOAD_LEN_LT_JZ : OP_LOCAL_LEN_LT_JZ); emit32(p, i); emit32(p, a);
+    } else {
+        emit(p, OP_JZ);
+    }
+    size_t pos = p->out->len; emit32(p, 0);
+    return pos;
+}
+
+// ---- Konstantenfaltung ----
+// Läuft wie die Fusion auf den zuletzt emittierten Instruktionen: ein
+// Operand, der als einzelnes PUSHI/PUSHI64 endet, ist eine Konstante. Gefaltet wird
+// mit derselben Arithmetik wie in der VM; die Identitäten (x+0, x*1, ...)
+// gelten nur, wenn x sicher ein Integer ist (sonst Typfehler bzw. aus true
+// würde 1), also x mit einer Instruktion endet, die nur Integer liefert.
+static void warn_line(P* p, int line, const char* msg){
+    if(p->warn) p->warn(p->user, line, msg);
+}
+
+// Einzelne Instruktion ohne Seiteneffekte, die genau einen Wert liefert
+static int tail_pure(P* p, int k){
+    int op = tail_op(p, k);
+    return op==OP_PUSHI || op==OP_LOAD || op==OP_LOAD_LOCAL;
+}
+
+// Instruktion k liefert (wenn sie nicht abbricht) immer einen Integer
+static int tail_int(P* p, int k){
+    switch(tail_op(p, k)){
+        case OP_PUSHI: case OP_PUSHI64:
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_ADD_CHK: case OP_SUB_CHK: case OP_MUL_CHK: case OP_DIV_CHK:
+        case OP_BAND: case OP_BOR: case OP_BXOR: case OP_LSH: case OP_RSH:
+        case OP_NEG: case OP_SHL: case OP_BNOT: case OP_POPCNT: case OP_CTZ:
+        case OP_LOAD_PUSHI_ADD: case OP_LOAD_LOCAL_PUSHI_ADD:
+        case OP_ALOAD: case OP_ALOAD_NC: case OP_ALEN: case OP_ASUM:
+        case OP_LOAD_LOAD_ALOAD: case OP_LOCAL_LOCAL_ALOAD:
+        case OP_LOAD_LOAD_ALOAD_NC: case OP_LOCAL_LOCAL_ALOAD_NC:
+            return 1;
+        default: return 0;
+    }
+}
+
+// Konstante k: PUSHI, wenn sie in ein i32 passt, sonst PUSHI64
+static void emit_pushi(P* p, int64_t v){
+    if(v >= INT32_MIN && v <= INT32_MAX){ emit(p, OP_PUSHI); emit32(p, (int32_t)v); return; }
+    emit(p, OP_PUSHI64); emit32(p, (int32_t)(uint32_t)v); emit32(p, (int32_t)(uint32_t)((uint64_t)v >> 32));
+}
+
+// Instruktion k ist eine Konstante: Wert nach *v
+static int tail_const(P* p, int k, int64_t* v){
+    int op = tail_op(p, k);
+    if(op==OP_PUSHI){ *v = tail_arg(p,k,0); return 1; }
+    if(op==OP_PUSHI64){ *v = (int64_t)(((uint64_t)(uint32_t)tail_arg(p,k,1) << 32) | (uint32_t)tail_arg(p,k,0)); return 1; }
+    return 0;
+}
+
+// ADD/SUB/MUL/DIV unter --checked als überlaufgeprüfte Variante
+static uint8_t arith_op(P* p, uint8_t op){
+    if(!p->checked) return op;
+    switch(op){
+        case OP_ADD: return OP_ADD_CHK;
+        case OP_SUB: return OP_SUB_CHK;
+        case OP_MUL: return OP_MUL_CHK;
+        case OP_DIV: return OP_DIV_CHK;
+        default: return op;
+    }
+}
+
+// a op b mit VM-Semantik (63-Bit-Integer, vm/value.h); 0 = nicht faltbar
+// (Division durch 0, Ergebnis außerhalb von 63 Bit: das entscheidet die VM,
+// je nach --checked mit Abbruch oder Wrap-around)
+static int fold_binop(uint8_t op, int64_t x, int64_t y, int64_t* r){
+    int64_t v; Value w;
+    switch(op){
+        case OP_ADD: if(v_add_ov(V_INT(x), V_INT(y), &w)) return 0; v = V_AS_INT(w); break;
+        case OP_SUB: if(v_sub_ov(V_INT(x), V_INT(y), &w)) return 0; v = V_AS_INT(w); break;
+        case OP_MUL: if(v_mul_ov(V_INT(x), V_INT(y), &w)) return 0; v = V_AS_INT(w); break;
+        case OP_DIV: case OP_MOD:
+            if(y == 0) return 0;
+            v = op==OP_DIV ? x / y : x % y; break;
+        case OP_EQ: v = x == y; break;
+        case OP_NE: v = x != y; break;
+        case OP_LT: v = x <  y; break;
+        case OP_LE: v = x <= y; break;
+        case OP_GT: v = x >  y; break;
+        case OP_GE: v = x >= y; break;
+        case OP_AND: v = x && y; break;
+        case OP_OR:  v = x || y; break;
+        case OP_BAND: v = x & y; break;
+        case OP_BOR:  v = x | y; break;
+        case OP_BXOR: v = x ^ y; break;
+        case OP_LSH: v = V_AS_INT(V_SHL(V_INT(x), V_INT(y))); break;
+        case OP_RSH: v = V_AS_INT(V_SHR(V_INT(x), V_INT(y))); break;
+        default: return 0;
+    }
+    if(v < V_INT_MIN || v > V_INT_MAX) return 0;
+    *r = v;
+    return 1;
+}
+
+static void emit_binop(P* p, uint8_t op){
+    int64_t k, k2;
+    if(tail_const(p,1,&k) && k==0 && (op==OP_DIV || op==OP_MOD))
+        warn_line(p, p->op_line, op==OP_DIV ? "division by zero" : "mod by zero");
+    if(p->opt < 1){ emit(p, arith_op(p, op)); return; }
+    if(tail_const(p,1,&k)){
+        // k1 op k2 -> PUSHI
+        int64_t r;
+        if(tail_const(p,2,&k2) && fold_binop(op, k2, k, &r)){
+            tail_drop(p, 2); emit_pushi(p, r); return;
+        }
+        // x+0, x-0, x|0, x^0, x<<0, x>>0, x*1, x/1 -> x  (x Integer)
+        if(tail_int(p,2) &&
+           (((op==OP_ADD || op==OP_SUB || op==OP_BOR || op==OP_BXOR || op==OP_LSH || op==OP_RSH) && k==0) ||
+            ((op==OP_MUL || op==OP_DIV) && k==1))){
+            tail_drop(p, 1); return;
+        }
+        // x << k -> SHL k
+        if(op==OP_LSH && k > 0 && k <= 31){
+            tail_drop(p, 1); emit(p, OP_SHL); emit32(p, (int32_t)k); return;
+        }
+        // x*0 -> 0 (nur wenn x keine Seiteneffekte hat und ein Integer ist)
+        if(op==OP_MUL && k==0 && tail_pure(p,2) && tail_int(p,2)){
+            tail_drop(p, 2); emit_pushi(p, 0); return;
+        }
+        // x * 2^n -> x << n  (SHL wickelt um, also nicht unter --checked)
+        if(op==OP_MUL && !p->checked && k > 0 && k <= INT32_MAX && (k & (k-1))==0){
+            int n = 0; while(((int64_t)1 << n) != k) n++;
+            tail_drop(p, 1); emit(p, OP_SHL); emit32(p, n); return;
+        }
+    } else if(tail_const(p,2,&k) && (op==OP_ADD || op==OP_MUL) &&
+              (tail_op(p,1)==OP_LOAD || tail_op(p,1)==OP_LOAD_LOCAL)){
+        // k + x, k * x: Operanden tauschen, damit die Regeln oben (und die
+        // LOAD_PUSHI_ADD-Fusion) greifen
+        uint8_t xop = (uint8_t)tail_op(p,1); int32_t x = tail_arg(p,1,0);
+        tail_drop(p, 2);
+        emit(p, xop); emit32(p, x);
+        emit_pushi(p, k);
+        emit_binop(p, op);
+        return;
+    }
+    if(p->checked) emit(p, arith_op(p, op));
+    else if(op==OP_ADD || op==OP_SUB) emit_addsub(p, op);
+    else emit(p, op);
+}
+
+// Einstelliger Operator; -x unter --checked als x * -1 mit MUL_CHK (-V_INT_MIN
+// passt nicht in 63 Bit)
+static void emit_un(P* p, uint8_t op){
+    if(op==OP_NEG && p->checked){ emit_pushi(p, -1); emit(p, OP_MUL_CHK); }
+    else emit(p, op);
+}
+
+static void emit_unop(P* p, uint8_t op){
+    if(p->opt < 1){ emit_un(p, op); return; }
+    int64_t k;
+    if(tail_const(p,1,&k) && !(op==OP_NEG && k==V_INT_MIN)){
+        tail_drop(p, 1);
+        emit_pushi(p, op==OP_NEG ? -k : op==OP_NOT ? !k : op==OP_BNOT ? ~k :
+                      op==OP_POPCNT ? v_popcount(k) : v_ctz(k));
+        return;
+    }
+    if(op==OP_NEG && tail_op(p,1)==OP_NEG && tail_int(p,2)){ tail_drop(p, 1); return; } // -(-x)
+    emit_un(p, op);
+}
+
+// ---- Bounds-Check-Elimination ----
+// Für Schleifen der Form
+//     i = k                    (Konstante k >= 0, direkt vor der Schleife)
+//     while (i < len(a)) { ... }
+// gilt 0 <= i < len(a) bei jedem Zugriff a[i] im Rumpf, der vor der ersten
+// Zuweisung an i liegt - vorausgesetzt, i wird im Rumpf nur um Konstanten
+// >= 0 erhöht (nicht in inneren Schleifen), a wird nicht neu zugewiesen
+// (Arrays haben feste Länge) und, falls i oder a global sind, es wird keine
+// Funktion aufgerufen. Solche Zugriffe werden nach dem Rumpf auf
+// ALOAD_NC/ASTORE_NC umgeschrieben; jede Verletzung verwirft die Schleife.
+static int ld_of_store(int op){ return op==OP_STORE ? OP_LOAD : OP_LOAD_LOCAL; }
+static int is_load(int op){ return op==OP_LOAD || op==OP_LOAD_LOCAL; }
+
+// Zuweisung an die Variable (ldop, slot); mono = Form i = i + k, 0 <= k < 2^31
+static void bce_assign(P* p, int ldop, int slot, int mono){
+    for(Bce* b = p->bce; b; b = b->outer){
+        if(b->aop==ldop && b->aslot==slot) b->invalid = 1;
+        if(b->iop==ldop && b->islot==slot){
+            if(!mono || p->loop_depth > b->depth) b->invalid = 1;
+            else b->i_dirty = 1;
+        }
+    }
+}
+static void bce_call(P* p){
+    for(Bce* b = p->bce; b; b = b->outer)
+        if(b->iop==OP_LOAD || b->aop==OP_LOAD) b->invalid = 1;
+}
+// Zugriff über die beiden letzten Instruktionen (LOAD a; LOAD i) prüfbar?
+static Bce* bce_match(P* p){
+    if(!is_load(tail_op(p,2)) || !is_load(tail_op(p,1))) return NULL;
+    int aop = tail_op(p,2), aslot = tail_arg(p,2,0), iop = tail_op(p,1), islot = tail_arg(p,1,0);
+    for(Bce* b = p->bce; b; b = b->outer)
+        if(b->aop==aop && b->aslot==aslot && b->iop==iop && b->islot==islot)
+            return (b->i_dirty || b->invalid) ? NULL : b;
+    return NULL;
+}
+static void bce_site(P* p, Bce* b, size_t pos){
+    if(!b) return;
+    if(b->nsites == b->cap){
+        int ncap = b->cap ? b->cap*2 : 8;
+        GROW(p->env, b->sites, b->cap, ncap);
+        b->cap = ncap;
+    }
+    b->sites[b->nsites++] = pos;
+}
+// RHS einer Zuweisung an (ldop, slot) ist i + k mit 0 <= k < 2^31
+static int tail_is_inc(P* p, int ldop, int slot){
+    int add = ldop==OP_LOAD ? OP_LOAD_PUSHI_ADD : OP_LOAD_LOCAL_PUSHI_ADD;
+    int64_t k;
+    if(tail_op(p,1)==add && tail_arg(p,1,0)==slot) return tail_arg(p,1,1) >= 0;
+    return tail_op(p,3)==ldop && tail_arg(p,3,0)==slot && tail_const(p,2,&k) && k >= 0 && k <= INT32_MAX &&
+           (tail_op(p,1)==OP_ADD || tail_op(p,1)==OP_ADD_CHK);
+}
+
+// ---- Expressions ----
+// Builtins als Opcode; -1 = kein Builtin mit diesem Namen und dieser Stelligkeit
+static int builtin_op(P* p, int name, int argc){
+    static const struct { const char* name; int argc, op; } tab[] = {
+        {"popcount", 1, OP_POPCNT}, {"ctz", 1, OP_CTZ},
+        {"array", 1, OP_ANEW}, {"len", 1, OP_ALEN}, {"sum", 1, OP_ASUM},
+        {"fill", 2, OP_AFILL}, {"copy", 2, OP_ACOPY}, {"add", 2, OP_AADD},
+    };
+    const char* s = intern_str(p->env->names, name);
+    for(size_t i=0;i<sizeof(tab)/sizeof(tab[0]);i++)
+        if(tab[i].argc==argc && strcmp(s, tab[i].name)==0) return tab[i].op;
+    return -1;
+}
+
+// ident "(" args ")": eigene Funktion oder Builtin, liefert genau einen Wert
+static void parse_call(P* p, int name){
+    expect(p, T_LP, "expected '('");
+    int argc = 0;
+    if (p->t.kind != T_RP) {
+        for(;;){
+            parse_expr(p); // Argument -> Stack
+            argc++;
+            if (!accept(p, T_COMMA)) break;
+        }
+    }
+    expect(p, T_RP, "expected ')'");
+    // Funktion lookup (belassen wir bis nach Definition möglich – Vorsicht: Forward geht hier NICHT)
+    int fid = env_find_func(p->env, name, argc);
+    // Builtins (eigene Funktionen gleichen Namens haben Vorrang)
+    int bop = fid < 0 ? builtin_op(p, name, argc) : -1;
+    if (bop == OP_POPCNT || bop == OP_CTZ) { emit_unop(p, (uint8_t)bop); return; }
+    if (bop >= 0) { emit(p, (uint8_t)bop); return; }
+    if (fid < 0) {
+        char m[320]; snprintf(m,sizeof(m),"undefined function '%s/%d'", intern_str(p->env->names, name), argc);
+        die_at(p->L, m);
+    }
+    // CALL absaddr, argc
+    emit(p, OP_CALL); emit32(p, p->env->funcs[fid].addr); emit32(p, argc);
+    bce_call(p);
+}
+
+// Variable laden: Local (in Funktionen) oder global
+static void emit_load_var(P* p, int name){
+    if (p->in_func) {
+        int k = sym_lookup_slot(p->sym, name);
+        if (k >= 0) { emit(p, OP_LOAD_LOCAL); emit32(p, k); return; }
+    }
+    int slot = env_find_var(p->env, name);
+    if(slot<0){
+        char m[320]; snprintf(m,sizeof(m),"undefined variable '%s'", intern_str(p->env->names, name)); die_at(p->L, m);
+    }
+    emit(p, OP_LOAD); emit32(p, slot);
+}
+
+static void parse_primary(P* p){
+    if(p->t.kind==T_INT){
+        emit_pushi(p, p->t.ival);
+        next(p); return;
+    }
+    if(p->t.kind==T_STRING){
+        int id = env_add_string(p->env, p->t.s, p->t.len);
+        emit(p, OP_PUSHSTR); emit32(p, id);
+        next(p); return;
+    }
+    if(p->t.kind==T_IDENT){
+        int name = p->t.id;
+        next(p);
+        if (p->t.kind == T_LP) parse_call(p, name);
+        else emit_load_var(p, name);
+        return;
+    }
+    if(accept(p, T_LP)){
+        parse_expr(p);
+        expect(p, T_RP, "expected ')'");
+        return;
+    }
+    die_at(p->L, "expected primary expression");
+}
+
+// primary { "[" expr "]" }
+// LOAD a; LOAD i; ALOAD  =>  LOAD_LOAD_ALOAD a i  (beide Global oder beide Local)
+static void parse_postfix(P* p){
+    parse_primary(p);
+    while(accept(p, T_LBR)){
+        parse_expr(p);
+        expect(p, T_RBR, "expected ']'");
+        Bce* b = p->opt >= 1 ? bce_match(p) : NULL;
+        int ld = tail_op(p,2);
+        if(p->opt >= 1 && is_load(ld) && tail_op(p,1)==ld){
+            int32_t a = tail_arg(p,2,0), i = tail_arg(p,1,0);
+            tail_drop(p, 2);
+            bce_site(p, b, p->out->len);
+            emit(p, ld==OP_LOAD ? OP_LOAD_LOAD_ALOAD : OP_LOCAL_LOCAL_ALOAD); emit32(p, a); emit32(p, i);
+        } else {
+            bce_site(p, b, p->out->len);
+            emit(p, OP_ALOAD);
+        }
+    }
+}
+
+static void parse_unary_fixed(P* p){
+    if(accept(p, T_MINUS)){
+        parse_unary_fixed(p);
+        emit_unop(p, OP_NEG);
+        return;
+    }
+    if(accept(p, T_BANG)){
+        parse_unary_fixed(p);
+        emit_unop(p, OP_NOT);
+        return;
+    }
+    if(accept(p, T_TILDE)){
+        parse_unary_fixed(p);
+        emit_unop(p, OP_BNOT);
+        return;
+    }
+    parse_postfix(p);
+}
+
+static void parse_mul(P* p){
+    parse_unary_fixed(p);
+    for(;;){
+        uint8_t op;
+        if(accept(p, T_STAR)) op = OP_MUL;
+        else if(accept(p, T_SLASH)) op = OP_DIV;
+        else if(accept(p, T_PCT)) op = OP_MOD;
+        else break;
+        p->op_line = p->L->line;
+        parse_unary_fixed(p);
+        emit_binop(p, op);
+    }
+}
+
+static void parse_add(P* p){
+    parse_mul(p);
+    for(;;){
+        if(accept(p, T_PLUS)){ parse_mul(p); emit_binop(p, OP_ADD); }
+        else if(accept(p, T_MINUS)){ parse_mul(p); emit_binop(p, OP_SUB); }
+        else break;
+    }
+}
+
+static void parse_shift(P* p){
+    parse_add(p);
+    for(;;){
+        if(accept(p, T_SHL)){ parse_add(p); emit_binop(p, OP_LSH); }
+        else if(accept(p, T_SHR)){ parse_add(p); emit_binop(p, OP_RSH); }
+        else break;
+    }
+}
+
+static void parse_cmp(P* p){
+    parse_shift(p);
+    for(;;){
+        if(accept(p, T_EQEQ)){ parse_shift(p); emit_binop(p, OP_EQ); }
+        else if(accept(p, T_NEQ)){ parse_shift(p); emit_binop(p, OP_NE); }
+        else if(accept(p, T_LT)){ parse_shift(p); emit_binop(p, OP_LT); }
+        else if(accept(p, T_LE)){ parse_shift(p); emit_binop(p, OP_LE); }
+        else if(accept(p, T_GT)){ parse_shift(p); emit_binop(p, OP_GT); }
+        else if(accept(p, T_GE)){ parse_shift(p); emit_binop(p, OP_GE); }
+        else break;
+    }
+}
+
+// Bitoperatoren binden wie in C schwächer als Vergleiche: & vor ^ vor |
+static void parse_bitand(P* p){
+    parse_cmp(p);
+    while(accept(p, T_AMP)){ parse_cmp(p); emit_binop(p, OP_BAND); }
+}
+
+static void parse_bitxor(P* p){
+    parse_bitand(p);
+    while(accept(p, T_CARET)){ parse_bitand(p); emit_binop(p, OP_BXOR); }
+}
+
+static void parse_bitor(P* p){
+    parse_bitxor(p);
+    while(accept(p, T_BAR)){ parse_bitxor(p); emit_binop(p, OP_BOR); }
+}
+
+// ---- && und || ----
+// Kurzschluss über Sprünge: jeder Operand endet in einem JZ (bzw. der
+// fusionierten Variante aus emit_jz), dessen Offset in einer Sprungliste
+// steht und später auf das Ziel gepatcht wird.
+typedef struct { size_t* pos; int n, cap; } Jumps;
+
+static void jumps_add(P* p, Jumps* j, size_t pos){
+    if(j->n == j->cap){
+        int ncap = j->cap ? j->cap*2 : 8;
+        GROW(p->env, j->pos, j->cap, ncap);
+        j->cap = ncap;
+    }
+    j->pos[j->n++] = pos;
+}
+// alle Sprünge der Liste auf die aktuelle Position (Label)
+static void jumps_patch(P* p, Jumps* j){
+    size_t to = mark_label(p);
+    for(int k=0;k<j->n;k++){
+        int32_t off = (int32_t)(to - j->pos[k] - 4);
+        memcpy(p->out->data + j->pos[k], &off, 4);
+    }
+    j->n = 0;
+}
+
+// or-Ausdruck. f != NULL: als Bedingung übersetzen - Sprung nach f, wenn
+// falsch, sonst weiter (if/while verzweigen direkt, ohne 0/1 zu erzeugen).
+// f == NULL: als Wert; mit && oder || liefert er 0 oder 1.
+//
+//   a && b || c:   <a> JZ n; <b> JNZ t; n: <c> JZ f; t: ...
+static void parse_or_cond(P* p, Jumps* f){
+    parse_bitor(p);
+    if(!f && p->t.kind != T_ANDAND && p->t.kind != T_OROR) return;
+    Jumps t = {0}, next = {0};
+    for(;;){
+        jumps_add(p, &next, emit_jz(p));
+        while(accept(p, T_ANDAND)){ parse_bitor(p); jumps_add(p, &next, emit_jz(p)); }
+        if(!accept(p, T_OROR)) break;
+        // Operand wahr: ganzer Ausdruck wahr. Ein einfaches JZ wird dazu zu JNZ
+        // auf t (falsch fällt in den nächsten Operanden), sonst JZ n; JMP t; n:
+        if(tail_op(p,1)==OP_JZ && next.pos[next.n-1] == p->out->len - 4){
+            p->out->data[p->out->len - 5] = OP_JNZ;
+            jumps_add(p, &t, next.pos[--next.n]);
+        } else {
+            emit(p, OP_JMP); jumps_add(p, &t, p->out->len); emit32(p, 0);
+        }
+        jumps_patch(p, &next);
+        parse_bitor(p);
+    }
+    if(t.n) jumps_patch(p, &t);   // Label nur wenn nötig (Fusion/BCE sehen sonst nichts)
+    if(f){
+        for(int k=0;k<next.n;k++) jumps_add(p, f, next.pos[k]);
+        return;
+    }
+    emit_pushi(p, 1);
+    emit(p, OP_JMP); size_t end = p->out->len; emit32(p, 0);
+    jumps_patch(p, &next);
+    emit_pushi(p, 0);
+    Jumps e = {0}; jumps_add(p, &e, end); jumps_patch(p, &e);
+}
+
+static void parse_expr(P* p){
+    parse_or_cond(p, NULL);
+}
+
+// Local im aktuellen Block; Frames haben höchstens NOVA_MAX_SLOTS Slots
+static int declare_local(P* p, int name){
+    int k = sym_declare(p->sym, name);
+    if(k < 0){
+        char m[64]; snprintf(m, sizeof(m), "out of local slots (max %d per function)", NOVA_MAX_SLOTS);
+        die_at(p->L, m);
+    }
+    return k;
+}
+
+static void parse_func(P* p){
+    // "func" ident "(" [params] ")" block
+    int fline = p->L->line;
+    if(!accept(p, K_FUNC)) die_at(p->L,"expected 'func'");
+    if(p->t.kind!=T_IDENT) die_at(p->L,"expected function name");
+    int fname = p->t.id; next(p);
+
+    // Frame: Parameter belegen die Locals 0..n-1 (liegen schon auf dem Stack)
+    sym_reset(p->sym);
+    scope_push(p->sym);
+    expect(p, T_LP, "expected '('");
+    int nparams=0;
+    if(p->t.kind != T_RP){
+        for(;;){
+            if(p->t.kind!=T_IDENT) die_at(p->L,"expected parameter name");
+            declare_local(p, p->t.id); nparams++;
+            next(p);
+            if(!accept(p, T_COMMA)) break;
+        }
+    }
+    expect(p, T_RP, "expected ')'");
+
+    // Adresse merken (Startpunkt der Funktion)
+    int addr = (int)mark_label(p);
+    line_mark(p, fline);
+    // Funktions-Signatur registrieren
+    env_add_func(p->env, fname, nparams, addr);
+
+    // ENTER mit Platzhalter: Anzahl Locals steht erst nach dem Rumpf fest
+    emit(p, OP_ENTER); size_t enter_pos = p->out->len; emit32(p, 0);
+
+    int old_in = p->in_func; p->in_func = 1;
+    parse_block(p);
+
+    // Falls kein explizites return: implizit 'return;' (ohne Wert)
+    emit(p, OP_RET); emit32(p, 0);
+
+    int32_t nlocals = (int32_t)(sym_slot_count(p->sym) - nparams);
+    memcpy(p->out->data + enter_pos, &nlocals, 4);
+    scope_pop(p->sym);
+    p->in_func = old_in;
+}
+
+
+// ---- Statements ----
+static void parse_stmt(P* p){
+    int line = p->L->line;
+    line_mark(p, line);
+    if(accept(p, K_LET)){
+        if(p->t.kind!=T_IDENT) die_at(p->L,"expected identifier after 'let'");
+        int name = p->t.id; next(p);
+        expect(p, T_EQ, "expected '=' after variable name");
+        parse_expr(p);
+        if(p->in_func){
+            // Local im aktuellen Block (Slot relativ zum Frame)
+            int k = declare_local(p, name);
+            bce_assign(p, OP_LOAD_LOCAL, k, 0);
+            emit_store(p, OP_STORE_LOCAL, k);
+            return;
+        }
+        int slot = env_add_var(p->env, name);
+        bce_assign(p, OP_LOAD, slot, 0);
+        emit_store(p, OP_STORE, slot);
+        return;
+    }
+    if(p->t.kind==T_IDENT){
+        int name = p->t.id; next(p);
+        if(p->t.kind==T_LP){
+            // Aufruf als Anweisung: Ergebnis verwerfen
+            parse_call(p, name);
+            emit(p, OP_POP);
+            return;
+        }
+        if(accept(p, T_LBR)){
+            // name[idx] = expr
+            emit_load_var(p, name);
+            parse_expr(p);
+            expect(p, T_RBR, "expected ']'");
+            Bce* b = p->opt >= 1 ? bce_match(p) : NULL;
+            expect(p, T_EQ, "expected '=' in assignment");
+            parse_expr(p);
+            if(b && (b->invalid || b->i_dirty)) b = NULL;
+            bce_site(p, b, p->out->len);
+            emit(p, OP_ASTORE);
+            return;
+        }
+        expect(p, T_EQ, "expected '=' in assignment");
+        parse_expr(p);
+        int op = OP_STORE, slot = -1;
+        if(p->in_func && (slot = sym_lookup_slot(p->sym, name)) >= 0) op = OP_STORE_LOCAL;
+        else slot = env_find_var(p->env, name);
+        if(slot<0){ char m[320]; snprintf(m,sizeof(m),"undefined variable '%s'", intern_str(p->env->names, name)); die_at(p->L, m); }
+        bce_assign(p, ld_of_store(op), slot, tail_is_inc(p, ld_of_store(op), slot));
+        emit_store(p, (uint8_t)op, slot);
+        return;
+    }
+    if(accept(p, K_PRINT)){
+        expect(p, T_LP, "expected '(' after print");
+        parse_expr(p);
+        expect(p, T_RP, "expected ')'");
+        emit(p, OP_PRINT);
+        return;
+    }
+    if(accept(p, K_PRINTLN)){
+        expect(p, T_LP, "expected '(' after println");
+        parse_expr(p);
+        expect(p, T_RP, "expected ')'");
+        emit(p, OP_PRINTLN);
+        return;
+    }
+    if(accept(p, K_IF)){
+        expect(p, T_LP, "expected '(' after if");
+        // Bedingung springt bei falsch nach else
+        Jumps f = {0};
+        parse_or_cond(p, &f);
+        expect(p, T_RP, "expected ')'");
+        parse_block(p);
+        // JMP end
+        emit(p, OP_JMP); size_t jmp_pos = p->out->len; emit32(p, 0);
+        // patch JZ to jump here
+        jumps_patch(p, &f);
+        if(accept(p, K_ELSE)){
+            parse_block(p);
+        }
+        // patch JMP to end
+        int32_t off_end = (int32_t)(mark_label(p) - jmp_pos - 4);
+        memcpy(p->out->data + jmp_pos, &off_end, 4);
+        return;
+    }
+    if(accept(p, K_WHILE)){
+        expect(p, T_LP, "expected '(' after while");
+        // Initialisierung direkt davor: PUSHI k (k >= 0); STORE i
+        int init_op = -1, init_slot = 0;
+        if((tail_op(p,1)==OP_STORE || tail_op(p,1)==OP_STORE_LOCAL) && tail_op(p,2)==OP_PUSHI && tail_arg(p,2,0) >= 0){
+            init_op = ld_of_store(tail_op(p,1)); init_slot = tail_arg(p,1,0);
+        }
+        size_t cond_pos = mark_label(p);
+        Jumps f = {0};
+        parse_or_cond(p, &f);
+        expect(p, T_RP, "expected ')'");
+        // Bedingung nur i < len(a): LOAD_LEN_LT_JZ i a (bzw. LOCAL_...) oder,
+        // bei gemischten Slots, LOAD i; LOAD a; ALEN; LT; JZ
+        Bce bce = {0};
+        int iop = -1, islot = 0, aop = -1, aslot = 0;
+        if(f.n == 1 && (tail_op(p,1)==OP_LOAD_LEN_LT_JZ || tail_op(p,1)==OP_LOCAL_LEN_LT_JZ)){
+            iop = aop = tail_op(p,1)==OP_LOAD_LEN_LT_JZ ? OP_LOAD : OP_LOAD_LOCAL;
+            islot = tail_arg(p,1,0); aslot = tail_arg(p,1,1);
+        } else if(f.n == 1 && tail_op(p,1)==OP_JZ && tail_op(p,2)==OP_LT && tail_op(p,3)==OP_ALEN &&
+                  is_load(tail_op(p,4)) && is_load(tail_op(p,5))){
+            iop = tail_op(p,5); islot = tail_arg(p,5,0);
+            aop = tail_op(p,4); aslot = tail_arg(p,4,0);
+        }
+        int use_bce = p->opt >= 1 && init_op >= 0 && iop == init_op && islot == init_slot &&
+                      !(aop == iop && aslot == islot);
+        if(use_bce){
+            bce.iop = iop; bce.islot = islot;
+            bce.aop = aop; bce.aslot = aslot;
+            bce.depth = p->loop_depth + 1;
+            bce.outer = p->bce; p->bce = &bce;
+        }
+        p->loop_depth++;
+        parse_block(p);
+        p->loop_depth--;
+        if(use_bce){
+            p->bce = bce.outer;
+            for(int k = 0; k < bce.nsites && !bce.invalid; k++){
+                uint8_t* op = p->out->data + bce.sites[k];
+                switch(*op){
+                    case OP_ALOAD:  *op = OP_ALOAD_NC; break;
+                    case OP_ASTORE: *op = OP_ASTORE_NC; break;
+                    case OP_LOAD_LOAD_ALOAD:   *op = OP_LOAD_LOAD_ALOAD_NC; break;
+                    case OP_LOCAL_LOCAL_ALOAD: *op = OP_LOCAL_LOCAL_ALOAD_NC; break;
+                    default: break;
+                }
+            }
+        }
+        // jump back to the start of the condition
+        line_mark(p, line);
+	emit(p, OP_JMP);
+	{
+	    // pc_after_operand = current_len + 4
+	    int32_t back = (int32_t)cond_pos - (int32_t)(p->out->len + 4);
+	    emit32(p, back);
+	}
+
+        // patch JZ to after block
+        jumps_patch(p, &f);
+        return;
+    }
+    // return nur im Funktionsrumpf (die VM hätte kein Frame zum Zurückkehren)
+    if (p->t.kind==K_RETURN && !p->in_func) die_at(p->L, "return outside function");
+    if (accept(p, K_RETURN)) {
+    // optionaler Ausdruck
+    if (p->t.kind==T_RP || p->t.kind==T_RB || p->t.kind==T_EOF) {
+        emit(p, OP_RET); emit32(p, 0);
+    } else {
+        parse_expr(p);
+        // return f(...): der Aufruf ist der ganze Ausdruck (jeder Operator
+        // kommt nach seinen Operanden) - TAILCALL verwendet das Frame weiter
+        if (p->in_func && tail_op(p,1)==OP_CALL) p->out->data[p->tail[NTAIL-1]] = OP_TAILCALL;
+        else { emit(p, OP_RET); emit32(p, 1); }
+    }
+    return;
+}
+    if(accept(p, T_LB)){
+        // block
+        while(p->t.kind!=T_RB && p->t.kind!=T_EOF){
+            parse_stmt(p);
+        }
+        expect(p, T_RB, "expected '}'");
+        return;
+    }
+    die_at(p->L, "unknown statement");
+}
+
+static void parse_block(P* p){
+    scope_push(p->sym);
+
+    if(!accept(p, T_LB)) die_at(p->L, "expected '{' to start block");
+    while(p->t.kind!=T_RB && p->t.kind!=T_EOF){
+        parse_stmt(p);
+    }
+    expect(p, T_RB, "expected '}'");
+
+    scope_pop(p->sym);
+}
+
+// ---- .nvc-Image ----
+// Wird direkt im Puffer des Aufrufers aufgebaut (NovaBytecode, wiederverwendet);
+// bc_put mit data == NULL reserviert nur n Bytes
+static void bc_put(Diag* d, NovaBytecode* b, const void* data, size_t n){
+    if(b->len + n > b->cap){
+        size_t ncap = b->cap ? b->cap : 4096;
+        while(ncap < b->len + n) ncap *= 2;
+        uint8_t* nd = (uint8_t*)realloc(b->data, ncap);
+        if(!nd) diag_fail(d, 0, "out of memory");
+        b->data = nd; b->cap = ncap;
+    }
+    if(n && data) memcpy(b->data + b->len, data, n);
+    b->len += n;
+}
+static void bc_u32(Diag* d, NovaBytecode* b, uint32_t v){
+    uint8_t x[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+    bc_put(d, b, x, 4);
+}
+
+// v1: sequentiell, Strings mit Längenpräfix
+static void write_nvc_v1(Diag* d, NovaBytecode* b, const Env* env, const CodeBuf* code, int regs, uint32_t nregs){
+    // Magic: "NOVABC01" = Stack-Bytecode, "NOVARC01" = Register-Flavour
+    bc_put(d, b, regs ? "NOVARC01" : "NOVABC01", 8);
+    bc_u32(d, b, (uint32_t)env->nstrs);
+    for(int i=0;i<env->nstrs;i++){
+        const char* s = env->strblob + env->stroff[i];
+        uint32_t slen = (uint32_t)strlen(s);
+        bc_u32(d, b, slen);
+        bc_put(d, b, s, slen);
+    }
+    if(regs) bc_u32(d, b, nregs);
+    bc_u32(d, b, (uint32_t)code->len);
+    bc_put(d, b, code->data, code->len);
+}
+
+// Debug-Sektion: Funktionsnamen und Zeilenprogramm (Format: vm/nvc.h)
+static size_t put_uleb(uint8_t* o, uint64_t v){
+    size_t n = 0;
+    do { uint8_t c = v & 0x7F; v >>= 7; if(o) o[n] = c | (v ? 0x80 : 0); n++; } while(v);
+    return n;
+}
+static size_t put_sleb(uint8_t* o, int64_t v){
+    size_t n = 0;
+    for(;;){
+        uint8_t c = v & 0x7F; v >>= 7;   // arithmetischer Shift
+        int done = (v == 0 && !(c & 0x40)) || (v == -1 && (c & 0x40));
+        if(o) o[n] = c | (done ? 0 : 0x80);
+        n++;
+        if(done) return n;
+    }
+}
+// Zeilentabelle als Zeilenprogramm nach o (NULL: nur Länge)
+static size_t line_program(uint8_t* o, const LineBuf* lines){
+    size_t n = 0;
+    uint32_t pc = 0; int32_t line = 1;
+    for(size_t i=0;i<lines->len;i++){
+        uint64_t dpc = lines->v[i].pc - pc;
+        int64_t dl = (int64_t)lines->v[i].line - line;
+        uint64_t op = dpc * NVC_LINE_RANGE + (uint64_t)(dl - NVC_LINE_BASE) + 1;
+        if(dl >= NVC_LINE_BASE && dl < NVC_LINE_BASE + NVC_LINE_RANGE && op <= 255){
+            if(o) o[n] = (uint8_t)op;
+            n++;
+        } else {
+            if(o) o[n] = 0;
+            n++;
+            n += put_uleb(o ? o + n : NULL, dpc);
+            n += put_sleb(o ? o + n : NULL, dl);
+        }
+        pc = lines->v[i].pc; line = lines->v[i].line;
+    }
+    return n;
+}
+// Funktionstabelle: nur Funktionen, die noch Code haben (addr >= 0)
+static uint32_t live_funcs(const Env* env){
+    uint32_t n = 0;
+    for(int i=0;i<env->nfuncs;i++) n += env->funcs[i].addr >= 0;
+    return n;
+}
+static uint32_t names_size(const Env* env){
+    uint64_t n = 0;
+    for(int i=0;i<env->nfuncs;i++)
+        if(env->funcs[i].addr >= 0) n += strlen(intern_str(env->names, env->funcs[i].name)) + 1;
+    return (uint32_t)n;
+}
+static uint64_t debug_size(const Env* env, const LineBuf* lines){
+    return 8 + 8 * (uint64_t)live_funcs(env) + names_size(env) + line_program(NULL, lines);
+}
+static void write_debug(Diag* d, NovaBytecode* b, const Env* env, const LineBuf* lines){
+    bc_u32(d, b, live_funcs(env));
+    bc_u32(d, b, names_size(env));
+    uint32_t name = 0;
+    for(int i=0;i<env->nfuncs;i++){
+        if(env->funcs[i].addr < 0) continue;
+        bc_u32(d, b, (uint32_t)env->funcs[i].addr);
+        bc_u32(d, b, name);
+        name += (uint32_t)strlen(intern_str(env->names, env->funcs[i].name)) + 1;
+    }
+    for(int i=0;i<env->nfuncs;i++){
+        if(env->funcs[i].addr < 0) continue;
+        const char* s = intern_str(env->names, env->funcs[i].name);
+        bc_put(d, b, s, strlen(s) + 1);
+    }
+    // direkt in den Ausgabepuffer kodieren
+    size_t n = line_program(NULL, lines);
+    bc_put(d, b, NULL, n);
+    line_program(b->data + b->len - n, lines);
+}
+
+// v2: Header mit Sektions-Offsets, Offset-Tabelle + String-Blob, ausgerichteter
+// Code, dahinter die Debug-Sektion (lines == NULL: ohne)
+static void write_nvc_v2(Diag* d, NovaBytecode* b, const Env* env, const CodeBuf* code, int regs, uint32_t nregs,
+                         const LineBuf* lines){
+    static const uint8_t zero[NVC_CODE_ALIGN];
+    uint32_t n = (uint32_t)env->nstrs;
+    uint64_t blob_len = env->blob_len;
+    uint64_t stroff_off = NVC_HEADER_SIZE;
+    uint64_t blob_off   = stroff_off + 4 * ((uint64_t)n + 1);
+    uint64_t code_off   = (blob_off + blob_len + NVC_CODE_ALIGN - 1) & ~(uint64_t)(NVC_CODE_ALIGN - 1);
+    uint64_t debug_off  = lines ? (code_off + code->len + 3) & ~(uint64_t)3 : 0;
+    uint64_t debug_len  = lines ? debug_size(env, lines) : 0;
+    uint64_t file_size  = lines ? debug_off + debug_len : code_off + code->len;
+    if(file_size > UINT32_MAX){
+        char m[96]; snprintf(m, sizeof(m), "output too large for .nvc (%llu bytes)", (unsigned long long)file_size);
+        diag_fail(d, 0, m);
+    }
+
+    bc_put(d, b, regs ? "NOVARC02" : "NOVABC02", 8);
+    bc_u32(d, b, NVC_HEADER_SIZE);
+    bc_u32(d, b, (uint32_t)file_size);
+    bc_u32(d, b, n);
+    bc_u32(d, b, regs ? nregs : 0);
+    bc_u32(d, b, (uint32_t)stroff_off);
+    bc_u32(d, b, (uint32_t)blob_off);
+    bc_u32(d, b, (uint32_t)blob_len);
+    bc_u32(d, b, (uint32_t)code_off);
+    bc_u32(d, b, (uint32_t)code->len);
+    bc_u32(d, b, 0);
+    bc_u32(d, b, (uint32_t)debug_off);
+    bc_u32(d, b, (uint32_t)debug_len);
+    for(uint32_t i=0;i<n;i++) bc_u32(d, b, env->stroff[i]);
+    bc_u32(d, b, env->blob_len);
+    bc_put(d, b, env->strblob, env->blob_len);
+    bc_put(d, b, zero, (size_t)(code_off - blob_off - blob_len));
+    bc_put(d, b, code->data, code->len);
+    if(lines){
+        bc_put(d, b, zero, (size_t)(debug_off - code_off - code->len));
+        write_debug(d, b, env, lines);
+    }
+}
+
+// ---- Bibliothek (novac.h) ----
+// Alles, was eine Übersetzung anlegt, hängt an einem NovaCompiler: Tabellen
+// und Env in der Arena, Code in cb/rcb. Zurücksetzen behält den Speicher.
+struct NovaCompiler {
+    NovaOptions o;
+    Arena   arena;
+    Intern  names;
+    SymTab  sym;
+    CodeBuf cb, rcb;         // Stack-Bytecode, ggf. Register-Flavour
+    LineBuf lines;           // Zeilentabelle zu cb
+    Diag    diag;            // Rücksprung bei Fehlern (diag.h)
+};
+
+void nova_options_default(NovaOptions* o){
+    memset(o, 0, sizeof(*o));
+    o->opt = 2;
+    o->format = 2;
+}
+
+NovaCompiler* nova_compiler_new(const NovaOptions* o){
+    NovaCompiler* c = (NovaCompiler*)calloc(1, sizeof(NovaCompiler));
+    if(!c) return NULL;
+    if(o) c->o = *o; else nova_options_default(&c->o);
+    if(c->o.opt < 0 || c->o.opt > 2) c->o.opt = 2;
+    if(c->o.format != 1) c->o.format = 2;
+    c->arena.diag = &c->diag;
+    cb_init(&c->cb);
+    cb_init(&c->rcb);
+    lb_init(&c->lines);
+    return c;
+}
+
+void nova_compiler_free(NovaCompiler* c){
+    if(!c) return;
+    arena_free(&c->arena);
+    cb_free(&c->cb);
+    cb_free(&c->rcb);
+    lb_free(&c->lines);
+    free(c);
+}
+
+// Eine Übersetzung; Fehler springen über c->diag zurück
+static void compile_unit(NovaCompiler* c, const char* src, size_t len, NovaBytecode* out){
+    // Namen, Symboltabelle und Env liegen in der Arena; Tokens sind Slices in src
+    intern_init(&c->names, &c->arena);
+    sym_init(&c->sym, &c->arena);
+    Lexer L; lx_init(&L, src, len, &c->arena, &c->names, &c->diag);
+    Env env; memset(&env, 0, sizeof(env));
+    env.arena = &c->arena;
+    env.names = &c->names;
+
+    P p;
+    memset(&p, 0, sizeof(p));
+    p.L   = &L;
+    p.out = &c->cb;
+    p.env = &env;
+    p.sym = &c->sym;
+    p.in_func  = 0;
+    p.opt      = c->o.opt;
+    p.checked  = c->o.checked;
+    p.warn     = c->o.warn;
+    p.user     = c->o.user;
+    p.lines    = &c->lines;
+
+    next(&p);
+    line_mark(&p, L.line);
+
+    // =====================================================================
+    //  Start-Jump einfügen, um Funktionsblöcke zu überspringen
+    // =====================================================================
+    emit(&p, OP_JMP);
+    size_t jmp_off_pos = p.out->len;  // Position der Offset-Bytes merken
+    emit32(&p, 0);                    // Platzhalter (4 Byte)
+
+    // =====================================================================
+    //  ZUERST: alle Funktionsdefinitionen einsammeln (vor dem Hauptprogramm)
+    // =====================================================================
+    while (p.t.kind == K_FUNC) {
+        parse_func(&p);
+    }
+
+    // =====================================================================
+    //  Jump-Offset patchen: jetzt kennen wir den Start des Hauptprogramms
+    // =====================================================================
+    {
+        int32_t rel = (int32_t)(mark_label(&p) - jmp_off_pos - 4); // relative Distanz ab hinterem Ende der 4 Offset-Bytes
+        memcpy(p.out->data + jmp_off_pos, &rel, 4);
+    }
+
+    // =====================================================================
+    //  DANACH: normale Top-Level-Statements (Hauptprogramm)
+    // =====================================================================
+    while (p.t.kind != T_EOF) {
+        parse_stmt(&p);
+    }
+    emit(&p, OP_HALT);
+
+    // -O2: Peephole auf dem fertigen Puffer; Zeilentabelle und
+    // Funktionsanfänge wandern mit (ohne Debug-Sektion nicht nötig)
+    if(c->o.opt >= 2 && c->o.strip){
+        if(peephole(&c->cb, NULL, 0, NULL) < 0)
+            diag_fail(&c->diag, 0, "internal error: peephole: malformed bytecode");
+    } else if(c->o.opt >= 2){
+        size_t nl = c->lines.len, npcs = nl + (size_t)env.nfuncs;
+        uint32_t* pcs = (uint32_t*)arena_alloc(&c->arena, (npcs + 1) * sizeof(uint32_t));
+        uint8_t* dropped = (uint8_t*)arena_alloc(&c->arena, npcs + 1);
+        memset(dropped, 0, npcs + 1);
+        for(size_t i=0;i<nl;i++) pcs[i] = c->lines.v[i].pc;
+        for(int i=0;i<env.nfuncs;i++) pcs[nl + (size_t)i] = (uint32_t)env.funcs[i].addr;
+        if(peephole(&c->cb, pcs, npcs, dropped) < 0)
+            diag_fail(&c->diag, 0, "internal error: peephole: malformed bytecode");
+        // entfernter Code: mehrere Einträge auf derselben Instruktion, der letzte gilt
+        size_t k = 0;
+        for(size_t i=0;i<nl;i++){
+            LineEnt e = { pcs[i], c->lines.v[i].line };
+            while(k && c->lines.v[k-1].pc >= e.pc) k--;
+            if(k && c->lines.v[k-1].line == e.line) continue;
+            c->lines.v[k++] = e;
+        }
+        c->lines.len = k;
+        // nie aufgerufene Funktionen sind weg; ihr Offset fiele sonst auf die
+        // nächste Funktion, deren Name in der Debug-Sektion verdeckt würde
+        for(int i=0;i<env.nfuncs;i++) env.funcs[i].addr = dropped[nl + (size_t)i] ? -1 : (int)pcs[nl + (size_t)i];
+    }
+
+    // Optional: Register-Flavour (Drei-Adress-Code) aus dem Stack-Code ableiten
+    int use_regs = c->o.regs;
+    uint32_t nregs = 0;
+    if(use_regs && !reg_translate(c->cb.data, c->cb.len, env.nvars, &c->rcb, &nregs)){
+        warn_line(&p, 0, "--regs: functions, arrays, 64-bit constants, x << 31 and --checked not supported by the register backend yet, writing stack bytecode");
+        use_regs = 0;
+    }
+    const CodeBuf* code = use_regs ? &c->rcb : &c->cb;
+
+    // =====================================================================
+    //  Image: MAGIC + Stringpool + Code (Formate: vm/nvc.h)
+    // =====================================================================
+    if(c->o.format == 1) write_nvc_v1(&c->diag, out, &env, code, use_regs, nregs);
+    else                 write_nvc_v2(&c->diag, out, &env, code, use_regs, nregs, use_regs || c->o.strip ? NULL : &c->lines);
+}
+
+int nova_compiler_compile(NovaCompiler* c, const char* src, size_t len, NovaBytecode* out, NovaDiag* err){
+    // Stand der letzten Übersetzung verwerfen, Speicher behalten
+    arena_reset(&c->arena);
+    c->cb.len = c->rcb.len = 0;
+    c->lines.len = 0;
+    out->len = 0;
+    if(setjmp(c->diag.jb)){
+        out->len = 0;
+        if(err){ err->line = c->diag.line; memcpy(err->msg, c->diag.msg, sizeof(err->msg)); }
+        return 0;
+    }
+    compile_unit(c, src, len, out);
+    return 1;
+}
+
+int nova_compile(const char* src, size_t len, NovaBytecode* out, NovaDiag* err){
+    NovaCompiler* c = nova_compiler_new(NULL);
+    if(!c){
+        if(err){ err->line = 0; snprintf(err->msg, sizeof(err->msg), "out of memory"); }
+        return 0;
+    }
+    int ok = nova_compiler_compile(c, src, len, out, err);
+    nova_compiler_free(c);
+    return ok;
+}
+
+void nova_bytecode_free(NovaBytecode* b){
+    free(b->data);
+    b->data = NULL; b->len = b->cap = 0;
+}
@@ -1,19 +1,23 @@
 #ifndef NOVA_DIAG_H
 #define NOVA_DIAG_H
+// Fehler beim Übersetzen: diag_fail hält Zeile und Meldung fest und springt
+// per longjmp an den Einstiegspunkt der Übersetzung zurück (setjmp in
+// nova_compiler_compile). Alles, was bis dahin angelegt wurde, liegt in der
+// Arena des Compilers; nichts wird ausgegeben, nichts beendet den Prozess.
+#include <setjmp.h>
 #include <stdio.h>
-#include <stdlib.h>
 
-static inline void die(const char* msg){
-    fprintf(stderr, "error: %s\n", msg);
-    exit(1);
-}
+typedef struct Diag {
+    jmp_buf jb;
+    int  line;             // 0 = ohne Zeile
+    char msg[256];
+} Diag;
 
-static inline void die_at(void* L, const char* msg){
-    // We can't access fields of Lexer here (opaque), so print generic form.
-    // novac.c already passes useful messages.
-    (void)L;
-    fprintf(stderr, "error: %s\n", msg);
-    exit(1);
+__attribute__((noreturn))
+static inline void diag_fail(Diag* d, int line, const char* msg){
+    d->line = line;
+    snprintf(d->msg, sizeof(d->msg), "%s", msg);
+    longjmp(d->jb, 1);
 }
 
 #endif
@@ -30,3 +30,26 @@ void cb_w32(CodeBuf* b, int32_t v){
     b->data[b->len+3] = (uint8_t)((v >> 24) & 0xFF);
     b->len += 4;
 }
+
+void lb_init(LineBuf* b){ b->v=NULL; b->len=0; b->cap=0; }
+void lb_free(LineBuf* b){
+    if (!b) return;
+    free(b->v); b->v=NULL;
+    b->len=0; b->cap=0;
+}
+
+void lb_mark(LineBuf* b, size_t pc, int line){
+    while (b->len && b->v[b->len-1].pc > pc) b->len--;
+    if (b->len && b->v[b->len-1].pc == pc) b->len--;
+    if (b->len && b->v[b->len-1].line == line) return;
+    if (b->len == b->cap) {
+        size_t ncap = b->cap ? b->cap * 2 : 256;
+        LineEnt* nv = (LineEnt*)realloc(b->v, ncap * sizeof(LineEnt));
+        if (!nv) { abort(); }
+        b->v = nv;
+        b->cap = ncap;
+    }
+    b->v[b->len].pc = (uint32_t)pc;
+    b->v[b->len].line = line;
+    b->len++;
+}
@@ -14,4 +14,19 @@ void cb_free(CodeBuf* b);
 void cb_w8(CodeBuf* b, uint8_t v);
 void cb_w32(CodeBuf* b, int32_t v);
 
+// Zeilentabelle: (Code-Offset, Quellzeile), aufsteigend nach Offset; ein
+// Eintrag gilt bis zum nächsten
+typedef struct { uint32_t pc; int32_t line; } LineEnt;
+typedef struct {
+    LineEnt* v;
+    size_t   len;
+    size_t   cap;
+} LineBuf;
+
+void lb_init(LineBuf* b);
+void lb_free(LineBuf* b);
+// Code ab pc gehört zu line. Einträge hinter pc (Code, den die Fusion wieder
+// entfernt hat) fallen weg, gleiche Zeile hintereinander bleibt ein Eintrag.
+void lb_mark(LineBuf* b, size_t pc, int line);
+
 #endif
@@ -0,0 +1,65 @@
+#include "intern.h"
+#include <string.h>
+
+struct InternName { char* s; uint32_t len; uint32_t hash; };
+
+static uint32_t hash_str(const char* s, size_t len){
+    uint32_t h = INTERN_HASH_INIT;
+    for(size_t i=0;i<len;i++) h = intern_hash_step(h, (uint8_t)s[i]);
+    return h;
+}
+
+static int32_t* probe(const Intern* t, uint32_t h, const char* s, size_t len){
+    for(uint32_t i = h & t->mask;; i = (i + 1) & t->mask){
+        int32_t* e = &t->slots[i];
+        if(*e == 0) return e;
+        const InternName* n = &t->names[*e - 1];
+        if(n->hash == h && n->len == len && memcmp(n->s, s, len) == 0) return e;
+    }
+}
+
+static void grow(Intern* t){
+    uint32_t size = t->mask ? 2*(t->mask + 1) : 256;
+    t->slots = (int32_t*)arena_alloc(t->arena, size * sizeof(int32_t));
+    memset(t->slots, 0, size * sizeof(int32_t));
+    t->mask = size - 1;
+    for(int id=0; id<t->count; id++){
+        uint32_t i = t->names[id].hash & t->mask;
+        while(t->slots[i]) i = (i + 1) & t->mask;
+        t->slots[i] = id + 1;
+    }
+}
+
+int intern_find(const Intern* t, const char* s, size_t len){
+    if(!t->slots) return -1;
+    int32_t* e = probe(t, hash_str(s, len), s, len);
+    return *e - 1;
+}
+
+int intern(Intern* t, const char* s, size_t len){ return intern_hashed(t, s, len, hash_str(s, len)); }
+
+int intern_hashed(Intern* t, const char* s, size_t len, uint32_t h){
+    if(2u*(uint32_t)(t->count + 1) > t->mask) grow(t);  // Füllgrad <= 1/2
+    int32_t* e = probe(t, h, s, len);
+    if(*e) return *e - 1;
+    if(t->count == t->cap){
+        int ncap = t->cap ? t->cap*2 : 256;
+        t->names = (InternName*)arena_grow(t->arena, t->names, (size_t)t->cap * sizeof(InternName), (size_t)ncap * sizeof(InternName));
+        t->cap = ncap;
+    }
+    InternName* n = &t->names[t->count];
+    n->s = arena_strndup(t->arena, s, len);
+    n->len = (uint32_t)len; n->hash = h;
+    *e = ++t->count;
+    return t->count - 1;
+}
+
+const char* intern_str(const Intern* t, int id){ return (id >= 0 && id < t->count) ? t->names[id].s : NULL; }
+int intern_count(const Intern* t){ return t->count; }
+
+void intern_init(Intern* t, Arena* a){ intern_reset(t); t->arena = a; }
+
+void intern_reset(Intern* t){
+    t->names = NULL; t->slots = NULL;
+    t->count = t->cap = 0; t->mask = 0;
+}
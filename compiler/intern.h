@@ -0,0 +1,35 @@
+#ifndef NOVA_INTERN_H
+#define NOVA_INTERN_H
+#include <stdint.h>
+#include <stddef.h>
+
+// Interned identifiers: each distinct name gets a dense id (0, 1, 2, ...),
+// so Env and the symbol table can index arrays by id instead of comparing
+// strings. Open addressing with linear probing; the hash of every entry is
+// stored, so probes compare hashes before touching the string.
+// A table belongs to one compilation (no globals); names and slots live in
+// the arena passed to intern_init (see arena.h).
+#include "arena.h"
+
+// FNV-1a; the lexer folds the hash into its identifier scan (intern_hashed)
+#define INTERN_HASH_INIT 2166136261u
+static inline uint32_t intern_hash_step(uint32_t h, unsigned char c){ return (h ^ c) * 16777619u; }
+
+typedef struct InternName InternName;
+typedef struct {
+    Arena*      arena;
+    InternName* names;     // id -> name
+    int         count, cap;
+    int32_t*    slots;     // hash table: id+1, 0 = free
+    uint32_t    mask;      // table size - 1 (power of two)
+} Intern;
+
+void        intern_init(Intern* t, Arena* a);
+int         intern(Intern* t, const char* s, size_t len);
+int         intern_hashed(Intern* t, const char* s, size_t len, uint32_t hash); // hash over s[0..len)  // id of s (added if new)
+int         intern_find(const Intern* t, const char* s, size_t len); // -1 if unknown
+const char* intern_str(const Intern* t, int id);
+int         intern_count(const Intern* t);
+void        intern_reset(Intern* t);       // forget all names (memory stays in the arena)
+
+#endif
@@ -0,0 +1,189 @@
+#include "lexer.h"
+#include "value.h"
+#include <string.h>
+
+// Zeichenklassen (ASCII wie im C-Locale; 0xA0 = NBSP zählt als Leerraum)
+enum { C_WS = 1, C_NL = 2, C_DIGIT = 4, C_ALPHA = 8 };
+#define W C_WS
+#define N (C_WS | C_NL)
+#define D C_DIGIT
+#define A C_ALPHA
+static const uint8_t cclass[256] = {
+/*        0 1 2 3 4 5 6 7 8 9 a b c d e f */
+/* 0x */  0,0,0,0,0,0,0,0,0,W,N,W,W,W,0,0,
+/* 1x */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+/* 2x */  W,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+/* 3x */  D,D,D,D,D,D,D,D,D,D,0,0,0,0,0,0,
+/* 4x */  0,A,A,A,A,A,A,A,A,A,A,A,A,A,A,A,
+/* 5x */  A,A,A,A,A,A,A,A,A,A,A,0,0,0,0,A,   /* '_' */
+/* 6x */  0,A,A,A,A,A,A,A,A,A,A,A,A,A,A,A,
+/* 7x */  A,A,A,A,A,A,A,A,A,A,A,0,0,0,0,0,
+/* 8x */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+/* 9x */  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+/* ax */  W,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+};
+#undef W
+#undef N
+#undef D
+#undef A
+
+void lx_init(Lexer* L, const char* src, size_t len, Arena* arena, Intern* names, Diag* diag){
+    L->src=src; L->len=len; L->pos=0; L->line=1; L->arena=arena; L->names=names; L->diag=diag;
+    // UTF-8 BOM am Dateianfang überspringen
+    if(len >= 3 && (unsigned char)src[0]==0xEF && (unsigned char)src[1]==0xBB && (unsigned char)src[2]==0xBF)
+        L->pos = 3;
+}
+
+static int lx_peek(Lexer* L){ return (L->pos<L->len)? (unsigned char)L->src[L->pos]: -1; }
+static int lx_get(Lexer* L){ int c=lx_peek(L); if(c==-1) return -1; L->pos++; if(c=='\n') L->line++; return c; }
+
+// Leerraum und //-Kommentare
+static void lx_skip_ws(Lexer* L){
+    const unsigned char* s = (const unsigned char*)L->src;
+    size_t i = L->pos, n = L->len;
+    int line = L->line;
+    for(;;){
+        while(i < n && (cclass[s[i]] & C_WS)){ line += (cclass[s[i]] & C_NL) != 0; i++; }
+        if(i + 1 < n && s[i]=='/' && s[i+1]=='/'){
+            const void* nl = memchr(s + i, '\n', n - i);
+            i = nl ? (size_t)((const unsigned char*)nl - s) : n;
+            continue;
+        }
+        break;
+    }
+    L->pos = i; L->line = line;
+}
+
+// Schlüsselwort nach Länge und erstem Zeichen; T_IDENT, wenn keins
+static TokKind keyword(const char* s, uint32_t len){
+    #define KW(w, k) if(memcmp(s, w, len) == 0) return k
+    switch(len){
+        case 2: KW("if", K_IF); break;
+        case 3: KW("let", K_LET); break;
+        case 4: if(s[0]=='e'){ KW("else", K_ELSE); } else { KW("func", K_FUNC); } break;
+        case 5: if(s[0]=='w'){ KW("while", K_WHILE); } else { KW("print", K_PRINT); } break;
+        case 6: KW("return", K_RETURN); break;
+        case 7: KW("println", K_PRINTLN); break;
+        default: break;
+    }
+    #undef KW
+    return T_IDENT;
+}
+
+Token lx_next(Lexer* L){
+    lx_skip_ws(L);
+    Token t; t.kind=T_EOF; t.s=NULL; t.len=0; t.ival=0; t.id=-1;
+    int c=lx_peek(L);
+    if(c==-1){ t.kind=T_EOF; return t; }
+    const unsigned char* s = (const unsigned char*)L->src;
+    uint8_t cl = cclass[c];
+
+    // identifiers / keywords
+    if(cl & C_ALPHA){
+        size_t start = L->pos, i = start + 1;
+        uint32_t h = intern_hash_step(INTERN_HASH_INIT, (unsigned char)c);
+        while(i < L->len && (cclass[s[i]] & (C_ALPHA | C_DIGIT))) h = intern_hash_step(h, s[i++]);
+        L->pos = i;
+        t.s = L->src + start; t.len = (uint32_t)(i - start);
+        t.kind = keyword(t.s, t.len);
+        if(t.kind == T_IDENT) t.id = intern_hashed(L->names, t.s, t.len, h);
+        return t;
+    }
+
+    // numbers
+    if(cl & C_DIGIT){
+        size_t i = L->pos;
+        int64_t v = 0;
+        while(i < L->len && (cclass[s[i]] & C_DIGIT)){
+            int d = s[i++] - '0';
+            if(v > (V_INT_MAX - d) / 10){ L->pos = i; die_at(L, "integer literal too large"); }
+            v = v*10 + d;
+        }
+        L->pos = i;
+        t.kind = T_INT; t.ival = v; return t;
+    }
+
+    // strings
+    if(c=='"'){
+        lx_get(L);
+        size_t start = L->pos; int esc = 0;
+        while((c=lx_get(L))!=-1 && c!='"'){
+            if(c=='\\'){ esc = 1; lx_get(L); }
+        }
+        if(c!='"') die_at(L,"unterminated string");
+        size_t n = L->pos - 1 - start;
+        t.kind=T_STRING; t.s = L->src + start; t.len = (uint32_t)n;
+        if(esc){
+            // dekodierte Fassung ist kürzer als der Quelltext
+            char* d = (char*)arena_alloc(L->arena, n + 1); size_t k = 0;
+            for(size_t i=0;i<n;i++){
+                char ch = t.s[i];
+                if(ch=='\\'){
+                    char e = t.s[++i];
+                    if(e=='n') ch='\n';
+                    else if(e=='t') ch='\t';
+                    else if(e=='"') ch='"';
+                    else if(e=='\\') ch='\\';
+                    else { die_at(L, "unknown escape"); }
+                }
+                d[k++] = ch;
+            }
+            d[k] = 0;
+            t.s = d; t.len = (uint32_t)k;
+        }
+        return t;
+    }
+
+    // operators / punctuation
+    c=lx_get(L);
+    switch(c){
+        case '(': t.kind=T_LP; break;
+        case ')': t.kind=T_RP; break;
+        case '{': t.kind=T_LB; break;
+        case '}': t.kind=T_RB; break;
+        case '+': t.kind=T_PLUS; break;
+        case '-': t.kind=T_MINUS; break;
+        case '*': t.kind=T_STAR; break;
+        case '/': t.kind=T_SLASH; break;
+        case '%': t.kind=T_PCT; break;
+        case ',': t.kind=T_COMMA; break;
+        case '^': t.kind=T_CARET; break;
+        case '[': t.kind=T_LBR; break;
+        case ']': t.kind=T_RBR; break;
+        case '~': t.kind=T_TILDE; break;
+        case '!':
+            if(lx_peek(L)=='='){ lx_get(L); t.kind=T_NEQ; }
+            else t.kind=T_BANG;
+            break;
+        case '=':
+            if(lx_peek(L)=='='){ lx_get(L); t.kind=T_EQEQ; }
+            else t.kind=T_EQ;
+            break;
+        case '<':
+            if(lx_peek(L)=='='){ lx_get(L); t.kind=T_LE; }
+            else if(lx_peek(L)=='<'){ lx_get(L); t.kind=T_SHL; }
+            else t.kind=T_LT;
+            break;
+        case '>':
+            if(lx_peek(L)=='='){ lx_get(L); t.kind=T_GE; }
+            else if(lx_peek(L)=='>'){ lx_get(L); t.kind=T_SHR; }
+            else t.kind=T_GT;
+            break;
+        case '&':
+            if(lx_peek(L)=='&'){ lx_get(L); t.kind=T_ANDAND; }
+            else t.kind=T_AMP;
+            break;
+        case '|':
+            if(lx_peek(L)=='|'){ lx_get(L); t.kind=T_OROR; }
+            else t.kind=T_BAR;
+            break;
+        default: {
+    char m[64];
+    unsigned uc = (unsigned)c & 0xFF;
+    snprintf(m, sizeof(m), "unexpected character '%c' (0x%02X)",
+             (uc>=32&&uc<127)?uc:'?', uc);
+    die_at(L, m);
+}
+    }
+    return t;
+}
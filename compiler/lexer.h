@@ -0,0 +1,40 @@
+#ifndef NOVA_LEXER_H
+#define NOVA_LEXER_H
+// Lexer von novac: tabellengesteuert (Zeichenklassen, Schlüsselwörter nach
+// Länge), Tokens sind Slices in den Quelltext. Fehler springen über
+// die_at mit der aktuellen Zeile zurück (diag.h).
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "diag.h"
+#include "intern.h"
+
+typedef struct { const char* src; size_t len; size_t pos; int line; Arena* arena; Intern* names; Diag* diag; } Lexer;
+
+__attribute__((noreturn))
+static inline void die_at(const Lexer* L, const char* msg){ diag_fail(L->diag, L->line, msg); }
+
+typedef enum {
+    T_EOF=0, T_IDENT, T_INT, T_STRING,
+    T_LP='(', T_RP=')', T_LB='{', T_RB='}',
+    T_EQ='=', T_PLUS='+', T_MINUS='-', T_STAR='*', T_SLASH='/', T_PCT='%',
+    T_LT='<', T_GT='>', T_BANG='!',
+    T_AMP='&', T_BAR='|', T_CARET='^', T_TILDE='~', T_LBR='[', T_RBR=']',
+    T_COMMA=',',
+    // multi-char
+    T_EQEQ=256, T_NEQ, T_LE, T_GE, T_ANDAND, T_OROR, T_SHL, T_SHR,
+    // keywords
+    K_LET, K_IF, K_ELSE, K_WHILE, K_PRINT, K_PRINTLN,
+    K_FUNC, K_RETURN
+} TokKind;
+
+// Text als Slice (s, len): Bezeichner zeigen in den Quelltext, Strings ohne
+// Escapes ebenso, mit Escapes in eine dekodierte Kopie in der Arena.
+typedef struct { TokKind kind; const char* s; uint32_t len; int64_t ival; int id; } Token; // id: interned Name (T_IDENT)
+
+// src muss bis zum Ende der Übersetzung leben (kein NUL am Ende nötig); ein
+// UTF-8-BOM am Anfang wird hier einmal übersprungen. Bezeichner landen in names.
+void  lx_init(Lexer* L, const char* src, size_t len, Arena* arena, Intern* names, Diag* diag);
+Token lx_next(Lexer* L);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef NOVA_NOVAC_H
+#define NOVA_NOVAC_H
+// libnovac - der Nova-Compiler als Bibliothek (der novac-CLI ist nur ein Aufrufer).
+//
+// Übersetzt Quelltext im Speicher in ein fertiges .nvc-Image (Format in
+// vm/nvc.h), das direkt an nova_program_load_mem (novavm.h) gehen oder in
+// eine Datei geschrieben werden kann. Fehler kommen als Rückgabewert mit
+// Zeile und Meldung zurück; nichts wird ausgegeben, nichts beendet den Prozess.
+//
+// Kein globaler Zustand: ein NovaCompiler hält Arena, Namens- und
+// Symboltabelle und Codepuffer. Jede Übersetzung setzt ihn zurück, ohne den
+// Speicher freizugeben - viele kleine Übersetzungen hintereinander kommen
+// ohne malloc aus. Verschiedene Compiler dürfen gleichzeitig in verschiedenen
+// Threads laufen; ein Compiler selbst nur in einem Thread zur Zeit.
+//
+//   NovaCompiler* c = nova_compiler_new(NULL);
+//   NovaBytecode bc = {0}; NovaDiag d;
+//   if(!nova_compiler_compile(c, src, len, &bc, &d)) fprintf(stderr, "line %d: %s\n", d.line, d.msg);
+//   ... bc.data/bc.len ...
+//   nova_bytecode_free(&bc); nova_compiler_free(c);
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct NovaCompiler NovaCompiler;
+
+// Ergebnis: .nvc-Image in data[0..len). data gehört dem Aufrufer (malloc) und
+// wird von der nächsten Übersetzung in denselben Puffer wiederverwendet.
+typedef struct { uint8_t* data; size_t len, cap; } NovaBytecode;
+// Fehler: Zeile im Quelltext (0 = ohne Zeile, z. B. Speichermangel) und Meldung
+typedef struct { int line; char msg[256]; } NovaDiag;
+// Warnungen (Division durch konstante 0, --regs-Rückfall, ...)
+typedef void (*NovaWarnFn)(void* user, int line, const char* msg);
+
+typedef struct {
+    int opt;            // 0..2 wie novac -O0..-O2
+    int regs;           // Register-Bytecode (sonst Stack-Bytecode, mit Warnung)
+    int checked;        // ADD/SUB/MUL mit Überlaufprüfung
+    int format;         // 1 = "NOVABC01", 2 = "NOVABC02"
+    int strip;          // ohne Debug-Sektion (Zeilen, Funktionsnamen; nur v2)
+    NovaWarnFn warn;    // NULL = Warnungen verwerfen
+    void* user;
+} NovaOptions;
+
+void nova_options_default(NovaOptions* o);       // -O2, Stack-Bytecode, v2 mit Debug-Sektion
+
+NovaCompiler* nova_compiler_new(const NovaOptions* o); // NULL = Voreinstellung; NULL bei OOM
+void          nova_compiler_free(NovaCompiler* c);
+
+// 1 = übersetzt (out gefüllt), 0 = Fehler (err gefüllt, out->len 0); err darf NULL sein
+int  nova_compiler_compile(NovaCompiler* c, const char* src, size_t len, NovaBytecode* out, NovaDiag* err);
+// einmalige Übersetzung mit Voreinstellungen (legt einen Compiler an und gibt
+// ihn wieder frei; für viele Übersetzungen nova_compiler_compile)
+int  nova_compile(const char* src, size_t len, NovaBytecode* out, NovaDiag* err);
+void nova_bytecode_free(NovaBytecode* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+#include "peephole.h"
+#include "opcodes.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Instruktionen werden mit Zielen als Instruktionsindex gehalten; Sprünge
+// sind damit unabhängig von Längenänderungen und werden erst beim
+// Zurückschreiben wieder in Byte-Offsets umgerechnet.
+
+#define DEAD (-1)
+
+typedef struct { int op; int32_t a, b, c; int32_t tgt; } PI;
+
+static int32_t rd32(const uint8_t* p){ int32_t v; memcpy(&v, p, 4); return v; }
+
+static int is_jump(int op){
+    return op==OP_JMP || op==OP_JZ || op==OP_JNZ || op==OP_LOAD_LOAD_LT_JZ || op==OP_LOCAL_LOCAL_LT_JZ || op==OP_LOAD_LEN_LT_JZ || op==OP_LOCAL_LEN_LT_JZ;
+}
+
+// pcs[k] (Byte-Offsets) werden dabei zu Instruktionsindizes: die erste
+// Instruktion ab diesem Offset
+static PI* decode(const CodeBuf* cb, int32_t* count, uint32_t* pcs, size_t npcs){
+    const uint8_t* code = cb->data; size_t len = cb->len;
+    int32_t* idx = (int32_t*)malloc((len + 1) * sizeof(int32_t));
+    if(!idx) abort();
+    int32_t n = 0;
+    for(size_t pc=0; pc<=len; pc++) idx[pc] = -1;
+    for(size_t pc=0; pc<len; ){
+        int olen = nova_op_operand_len(code[pc]);
+        if(olen < 0 || pc + 1 + (size_t)olen > len){ free(idx); return NULL; }
+        idx[pc] = n++;
+        pc += 1 + (size_t)olen;
+    }
+    idx[len] = n;
+    PI* v = (PI*)calloc((size_t)n + 1, sizeof(PI));
+    if(!v) abort();
+    int ok = 1;
+    for(size_t pc=0, i=0; pc<len; i++){
+        int op = code[pc], olen = nova_op_operand_len(op);
+        size_t next = pc + 1 + (size_t)olen;
+        PI* in = &v[i];
+        in->op = op; in->tgt = -1;
+        if(olen >= 4)  in->a = rd32(&code[pc+1]);
+        if(olen >= 8)  in->b = rd32(&code[pc+5]);
+        if(olen >= 12) in->c = rd32(&code[pc+9]);
+        int64_t t = -1;
+        if(op==OP_JMP || op==OP_JZ || op==OP_JNZ) t = (int64_t)next + in->a;
+        else if(op==OP_LOAD_LOAD_LT_JZ || op==OP_LOCAL_LOCAL_LT_JZ || op==OP_LOAD_LEN_LT_JZ || op==OP_LOCAL_LEN_LT_JZ) t = (int64_t)next + in->c;
+        else if(op==OP_CALL || op==OP_TAILCALL)   t = (uint32_t)in->a;
+        if(is_jump(op) || op==OP_CALL || op==OP_TAILCALL){
+            if(t < 0 || t > (int64_t)len || idx[t] < 0){ ok = 0; break; }
+            in->tgt = idx[t];
+        }
+        pc = next;
+    }
+    for(size_t k=0;k<npcs && ok;k++){
+        size_t pc = pcs[k] < len ? pcs[k] : len;
+        while(idx[pc] < 0) pc++;
+        pcs[k] = (uint32_t)idx[pc];
+    }
+    free(idx);
+    if(!ok){ free(v); return NULL; }
+    *count = n;
+    return v;
+}
+
+// pcs[k]: Instruktionsindex -> neuer Byte-Offset
+static void encode(CodeBuf* cb, const PI* v, int32_t n, uint32_t* pcs, size_t npcs){
+    size_t* off = (size_t*)malloc(((size_t)n + 1) * sizeof(size_t));
+    if(!off) abort();
+    size_t pos = 0;
+    for(int32_t i=0;i<n;i++){ off[i] = pos; pos += 1 + (size_t)nova_op_operand_len(v[i].op); }
+    off[n] = pos;
+    for(size_t k=0;k<npcs;k++) pcs[k] = (uint32_t)off[pcs[k]];
+    cb->len = 0;
+    for(int32_t i=0;i<n;i++){
+        const PI* in = &v[i];
+        int olen = nova_op_operand_len(in->op);
+        size_t end = off[i] + 1 + (size_t)olen;
+        int32_t a = in->a, c = in->c;
+        if(in->op==OP_JMP || in->op==OP_JZ || in->op==OP_JNZ) a = (int32_t)((int64_t)off[in->tgt] - (int64_t)end);
+        else if(in->op==OP_LOAD_LOAD_LT_JZ || in->op==OP_LOCAL_LOCAL_LT_JZ || in->op==OP_LOAD_LEN_LT_JZ || in->op==OP_LOCAL_LEN_LT_JZ) c = (int32_t)((int64_t)off[in->tgt] - (int64_t)end);
+        else if(in->op==OP_CALL || in->op==OP_TAILCALL)        a = (int32_t)off[in->tgt];
+        cb_w8(cb, (uint8_t)in->op);
+        if(olen >= 4)  cb_w32(cb, a);
+        if(olen >= 8)  cb_w32(cb, in->b);
+        if(olen >= 12) cb_w32(cb, c);
+    }
+    free(off);
+}
+
+// Gelöschte Instruktionen entfernen; Ziele auf gelöschte Instruktionen
+// wandern zur nächsten lebenden, ebenso die Indizes in pcs.
+static int32_t compact(PI* v, int32_t n, uint32_t* pcs, size_t npcs){
+    int32_t* map = (int32_t*)malloc(((size_t)n + 1) * sizeof(int32_t));
+    if(!map) abort();
+    int32_t m = 0;
+    for(int32_t i=0;i<n;i++){ map[i] = m; if(v[i].op != DEAD) m++; }
+    map[n] = m;
+    for(size_t k=0;k<npcs;k++) pcs[k] = (uint32_t)map[pcs[k]];
+    m = 0;
+    for(int32_t i=0;i<n;i++){
+        if(v[i].op == DEAD) continue;
+        v[m] = v[i];
+        if(v[m].tgt >= 0) v[m].tgt = map[v[m].tgt];
+        m++;
+    }
+    free(map);
+    return m;
+}
+
+// Instruktionen, die von 0 aus weder per Durchfallen noch per Sprung/CALL
+// erreichbar sind, löschen
+static int drop_unreachable(PI* v, int32_t n){
+    uint8_t* seen = (uint8_t*)calloc((size_t)n + 1, 1);
+    int32_t* work = (int32_t*)malloc(((size_t)n + 1) * 2 * sizeof(int32_t));
+    if(!seen || !work) abort();
+    int32_t top = 0;
+    if(n > 0){ work[top++] = 0; seen[0] = 1; }
+    while(top > 0){
+        int32_t i = work[--top];
+        int op = v[i].op;
+        int32_t succ[2]; int ns = 0;
+        if(op != OP_JMP && op != OP_RET && op != OP_TAILCALL && op != OP_HALT) succ[ns++] = i + 1;
+        if(v[i].tgt >= 0) succ[ns++] = v[i].tgt;
+        for(int k=0;k<ns;k++){
+            if(succ[k] < n && !seen[succ[k]]){ seen[succ[k]] = 1; work[top++] = succ[k]; }
+        }
+    }
+    int changed = 0;
+    for(int32_t i=0;i<n;i++) if(!seen[i]){ v[i].op = DEAD; changed = 1; }
+    free(seen); free(work);
+    return changed;
+}
+
+// Eine Runde lokaler Umschreibungen; ref[i] = Anzahl Sprünge/CALLs auf i
+static int rewrite(PI* v, int32_t n, const int32_t* ref){
+    int changed = 0;
+    for(int32_t i=0;i<n;i++){
+        PI* in = &v[i];
+        PI* nx = (i + 1 < n) ? &v[i+1] : NULL;
+        int nx_free = nx && ref[i+1] == 0;   // nx ist kein Sprungziel
+
+        // Sprung auf Sprung: direkt auf das Endziel
+        if(is_jump(in->op)){
+            int32_t t = in->tgt;
+            for(int32_t hops=0; t < n && v[t].op==OP_JMP && v[t].tgt != t && hops < n; hops++) t = v[t].tgt;
+            if(t != in->tgt){ in->tgt = t; changed = 1; }
+        }
+        // JMP auf RET/HALT: Ziel kopieren
+        if(in->op==OP_JMP && in->tgt < n && (v[in->tgt].op==OP_RET || v[in->tgt].op==OP_HALT)){
+            in->op = v[in->tgt].op; in->a = v[in->tgt].a; in->tgt = -1;
+            changed = 1; continue;
+        }
+        // JMP auf die nächste Instruktion, Funktion ohne Locals
+        if((in->op==OP_JMP && in->tgt == i + 1) || (in->op==OP_ENTER && in->a == 0)){ in->op = DEAD; changed = 1; continue; }
+        // JZ L; JMP M; L:  =>  JNZ M   (und umgekehrt)
+        if((in->op==OP_JZ || in->op==OP_JNZ) && nx_free && nx->op==OP_JMP && in->tgt == i + 2){
+            in->op = in->op==OP_JZ ? OP_JNZ : OP_JZ; in->tgt = nx->tgt;
+            nx->op = DEAD; changed = 1; i++; continue;
+        }
+        // STORE s; LOAD s  =>  TEE s
+        if(in->op==OP_STORE && nx_free && nx->op==OP_LOAD && nx->a == in->a){
+            in->op = OP_TEE; nx->op = DEAD; changed = 1; i++; continue;
+        }
+        // LOAD s; STORE s  =>  nichts
+        if(in->op==OP_LOAD && nx_free && nx->op==OP_STORE && nx->a == in->a){
+            in->op = DEAD; nx->op = DEAD; changed = 1; i++; continue;
+        }
+        // PUSHI k; JZ/JNZ: Sprung steht zur Compile-Zeit fest
+        if(in->op==OP_PUSHI && nx_free && (nx->op==OP_JZ || nx->op==OP_JNZ)){
+            int taken = (nx->op==OP_JZ) == (in->a == 0);
+            in->op = DEAD;
+            if(taken) nx->op = OP_JMP; else nx->op = DEAD;
+            changed = 1; i++; continue;
+        }
+    }
+    return changed;
+}
+
+int peephole(CodeBuf* cb, uint32_t* pcs, size_t npcs, uint8_t* dropped){
+    int32_t n = 0;
+    PI* v = decode(cb, &n, pcs, npcs);
+    if(!v) return -1;
+    int32_t n0 = n;
+    int32_t* ref = (int32_t*)malloc(((size_t)n + 1) * sizeof(int32_t));
+    if(!ref) abort();
+    for(;;){
+        memset(ref, 0, ((size_t)n + 1) * sizeof(int32_t));
+        for(int32_t i=0;i<n;i++) if(v[i].tgt >= 0) ref[v[i].tgt]++;
+        int changed = rewrite(v, n, ref);
+        n = compact(v, n, pcs, npcs);
+        changed |= drop_unreachable(v, n);
+        // vor dem Verschieben: pcs auf unerreichbarem Code melden
+        for(size_t k=0;dropped && k<npcs;k++) if((int32_t)pcs[k] < n && v[pcs[k]].op == DEAD) dropped[k] = 1;
+        n = compact(v, n, pcs, npcs);
+        if(!changed) break;
+    }
+    encode(cb, v, n, pcs, npcs);
+    free(ref); free(v);
+    return n0 - n;
+}
@@ -0,0 +1,18 @@
+#ifndef NOVA_PEEPHOLE_H
+#define NOVA_PEEPHOLE_H
+#include <stddef.h>
+#include <stdint.h>
+#include "emit.h"
+
+// Peephole-Optimierung auf fertigem Stack-Bytecode (novac -O2).
+// Dekodiert den Puffer, wendet lokale Umschreibungen bis zum Fixpunkt an,
+// entfernt unerreichbaren Code und kodiert mit neu berechneten Sprung- und
+// Call-Zielen zurück. Liefert die Anzahl eingesparter Instruktionen, -1 bei
+// unlesbarem Code (Puffer bleibt dann unverändert).
+// pcs[0..npcs): Code-Offsets (Zeilentabelle, Funktionsanfänge), die mit
+// umgerechnet werden; ein Offset auf entfernten Code wandert zur nächsten
+// verbleibenden Instruktion. dropped[k] (darf NULL sein) wird 1, wenn der
+// Code an pcs[k] als unerreichbar entfernt wurde (nie aufgerufene Funktion).
+int peephole(CodeBuf* cb, uint32_t* pcs, size_t npcs, uint8_t* dropped);
+
+#endif
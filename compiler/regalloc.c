@@ -0,0 +1,285 @@
+#include "regalloc.h"
+#include "opcodes.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Stack -> Register per abstrakter Interpretation des Operandenstacks.
+//
+// Jeder Stackeintrag wird symbolisch gehalten (Register, int-Konstante oder
+// String-Id) und erst materialisiert, wenn es nötig ist. Temporaries werden
+// nach Stacktiefe vergeben (Eintrag i lebt immer in T(i)), Konstanten bekommen
+// eigene Register, die ein Prolog einmalig lädt. Ein STORE direkt nach einer
+// Rechenoperation schreibt deren Ziel um (LOAD a; LOAD b; ADD; STORE c wird
+// zu ADD c, a, b). An Sprungzielen und vor Sprüngen liegt der Stack immer
+// kanonisch in T(0..depth).
+
+enum { SV_REG, SV_INT, SV_STR };
+typedef struct { int kind; int32_t v; } SymVal;
+typedef struct { size_t pos; uint32_t target; } Fix;
+typedef struct { int kind; int32_t v; } Const;
+
+typedef struct {
+    const uint8_t* code; size_t len;
+    int nslots, ntemps;
+    int32_t* depth;          // Stacktiefe am Sprungziel, -1 = kein Ziel
+    size_t*  map;            // Stack-pc -> Register-pc (nur Sprungziele)
+    Fix*   fixes;  size_t nfix, capfix;
+    Const* consts; int nconst, capconst;
+    SymVal* stk; int sp;
+    CodeBuf* out;
+    size_t last_ins;         // Start der letzten Instruktion
+    int    last_dst;         // Zielregister der letzten ALU-Instruktion, -1 = keine
+} RA;
+
+static int32_t rd32(const uint8_t* p){ int32_t v; memcpy(&v, p, 4); return v; }
+static void put32(CodeBuf* b, size_t pos, int32_t v){ memcpy(b->data + pos, &v, 4); }
+
+static int tmp_reg(RA* r, int d){ return r->nslots + d; }
+
+static int const_reg(RA* r, int kind, int32_t v){
+    for(int i=0;i<r->nconst;i++)
+        if(r->consts[i].kind==kind && r->consts[i].v==v) return r->nslots + r->ntemps + i;
+    if(r->nconst == r->capconst){
+        r->capconst = r->capconst ? r->capconst*2 : 16;
+        r->consts = (Const*)realloc(r->consts, (size_t)r->capconst * sizeof(Const));
+        if(!r->consts) abort();
+    }
+    r->consts[r->nconst].kind = kind; r->consts[r->nconst].v = v;
+    return r->nslots + r->ntemps + r->nconst++;
+}
+
+static void ins(RA* r, int op){ r->last_ins = r->out->len; r->last_dst = -1; cb_w8(r->out, (uint8_t)op); }
+
+static void jump_to(RA* r, uint32_t target){
+    if(r->nfix == r->capfix){
+        r->capfix = r->capfix ? r->capfix*2 : 64;
+        r->fixes = (Fix*)realloc(r->fixes, r->capfix * sizeof(Fix));
+        if(!r->fixes) abort();
+    }
+    r->fixes[r->nfix].pos = r->out->len; r->fixes[r->nfix].target = target; r->nfix++;
+    cb_w32(r->out, 0);
+}
+
+static int opnd(RA* r, SymVal v){
+    return v.kind==SV_REG ? v.v : const_reg(r, v.kind, v.v);
+}
+
+static void materialize(RA* r, int i){
+    SymVal* e = &r->stk[i];
+    int t = tmp_reg(r, i);
+    if(e->kind==SV_REG && e->v==t) return;
+    if(e->kind==SV_REG){ ins(r, R_MOV); cb_w32(r->out, t); cb_w32(r->out, e->v); }
+    else { ins(r, e->kind==SV_INT ? R_MOVI : R_MOVS); cb_w32(r->out, t); cb_w32(r->out, e->v); }
+    e->kind = SV_REG; e->v = t;
+}
+static void flush(RA* r){ for(int i=0;i<r->sp;i++) materialize(r, i); }
+
+// Einträge, die noch den alten Wert von Slot s lesen, vor dem Überschreiben sichern
+static void protect_slot(RA* r, int s){
+    for(int i=0;i<r->sp;i++) if(r->stk[i].kind==SV_REG && r->stk[i].v==s) materialize(r, i);
+}
+
+static void push(RA* r, int kind, int32_t v){ r->stk[r->sp].kind = kind; r->stk[r->sp].v = v; r->sp++; }
+
+static void alu(RA* r, int rop, int ra, int rb){
+    int d = tmp_reg(r, r->sp);
+    ins(r, rop); cb_w32(r->out, d); cb_w32(r->out, ra); cb_w32(r->out, rb);
+    r->last_dst = d;
+    push(r, SV_REG, d);
+}
+
+// Pass 1: Stacktiefe an Sprungzielen und maximale Tiefe bestimmen
+static int scan(RA* r){
+    int d = 0, maxd = 0;
+    for(size_t pc=0; pc<r->len; ){
+        int op = r->code[pc];
+        int olen = nova_op_operand_len(op);
+        if(olen < 0 || pc + 1 + (size_t)olen > r->len) return 0;
+        size_t next = pc + 1 + (size_t)olen;
+        if(r->depth[pc] >= 0) d = r->depth[pc];
+        int64_t tgt = -1;
+        switch(op){
+            case OP_PUSHI: case OP_PUSHSTR: case OP_LOAD: case OP_LOAD_PUSHI_ADD: d++; break;
+            case OP_STORE: case OP_PRINT: case OP_PRINTLN: d--; break;
+            case OP_NOT: case OP_NEG: case OP_TEE: case OP_INC_SLOT: case OP_HALT: break;
+            // x << k wird x * 2^k; 2^31 passt nicht in eine 32-Bit-Konstante
+            case OP_SHL: if((uint32_t)rd32(&r->code[pc+1]) > 30) return 0; break;
+            case OP_JMP: tgt = (int64_t)next + rd32(&r->code[pc+1]); break;
+            case OP_JZ: case OP_JNZ: d--; tgt = (int64_t)next + rd32(&r->code[pc+1]); break;
+            case OP_LOAD_LOAD_LT_JZ: tgt = (int64_t)next + rd32(&r->code[pc+9]); break;
+            case OP_CALL: case OP_RET: case OP_LOAD_LOCAL: return 0;
+            default:
+                if(op >= OP_ADD && op <= OP_OR){ d--; break; }
+                return 0;
+        }
+        if(d < 0) return 0;
+        if(d > maxd) maxd = d;
+        if(tgt >= 0){
+            if(tgt > (int64_t)r->len) return 0;
+            r->depth[tgt] = d;
+        }
+        if(op==OP_JMP || op==OP_HALT) d = 0; // folgender Code nur über Sprungziel erreichbar
+        pc = next;
+    }
+    r->ntemps = maxd + 1;
+    return 1;
+}
+
+static void emit_body(RA* r){
+    for(size_t pc=0; pc<r->len; ){
+        int op = r->code[pc];
+        size_t next = pc + 1 + (size_t)nova_op_operand_len(op);
+        const uint8_t* a = &r->code[pc+1];
+        if(r->depth[pc] >= 0){
+            flush(r);
+            r->sp = r->depth[pc];
+            for(int i=0;i<r->sp;i++){ r->stk[i].kind = SV_REG; r->stk[i].v = tmp_reg(r, i); }
+            r->map[pc] = r->out->len;
+            r->last_dst = -1;
+        }
+        switch(op){
+            case OP_PUSHI:   push(r, SV_INT, rd32(a)); break;
+            case OP_PUSHSTR: push(r, SV_STR, rd32(a)); break;
+            case OP_LOAD:    push(r, SV_REG, rd32(a)); break;
+            case OP_STORE: case OP_TEE: {
+                int s = rd32(a);
+                SymVal v = r->stk[--r->sp];
+                protect_slot(r, s);
+                if(v.kind==SV_REG && v.v==r->last_dst && v.v >= r->nslots){
+                    put32(r->out, r->last_ins + 1, s);      // Ziel umschreiben
+                    r->last_dst = -1;
+                } else if(v.kind==SV_REG){
+                    ins(r, R_MOV); cb_w32(r->out, s); cb_w32(r->out, v.v);
+                } else {
+                    ins(r, v.kind==SV_INT ? R_MOVI : R_MOVS); cb_w32(r->out, s); cb_w32(r->out, v.v);
+                }
+                if(op==OP_TEE) push(r, SV_REG, s);   // Wert bleibt, jetzt in Slot s
+            } break;
+            case OP_INC_SLOT: {
+                int s = rd32(a);
+                protect_slot(r, s);
+                int k = const_reg(r, SV_INT, rd32(a+4));
+                ins(r, R_ADD); cb_w32(r->out, s); cb_w32(r->out, s); cb_w32(r->out, k);
+            } break;
+            case OP_LOAD_PUSHI_ADD:
+                alu(r, R_ADD, rd32(a), const_reg(r, SV_INT, rd32(a+4)));
+                break;
+            case OP_NOT: {
+                SymVal v = r->stk[--r->sp];
+                int ra = opnd(r, v);
+                int d = tmp_reg(r, r->sp);
+                ins(r, R_NOT); cb_w32(r->out, d); cb_w32(r->out, ra);
+                r->last_dst = d;
+                push(r, SV_REG, d);
+            } break;
+            // kein eigener Registerbefehl: -x = 0 - x, x << k = x * 2^k
+            case OP_NEG: {
+                SymVal v = r->stk[--r->sp];
+                int ra = opnd(r, v);
+                alu(r, R_SUB, const_reg(r, SV_INT, 0), ra);
+            } break;
+            case OP_SHL: {
+                SymVal v = r->stk[--r->sp];
+                int ra = opnd(r, v);
+                alu(r, R_MUL, ra, const_reg(r, SV_INT, (int32_t)1 << rd32(a)));
+            } break;
+            case OP_JMP:
+                flush(r);
+                ins(r, R_JMP); jump_to(r, (uint32_t)((int64_t)next + rd32(a)));
+                break;
+            case OP_JZ: case OP_JNZ: {
+                uint32_t tgt = (uint32_t)((int64_t)next + rd32(a));
+                SymVal c = r->stk[--r->sp];
+                if(c.kind==SV_REG && c.v==r->last_dst){
+                    // Vergleich + JZ -> bedingter Sprung auf die Negation,
+                    // Vergleich + JNZ -> bedingter Sprung auf den Vergleich
+                    int cop = r->out->data[r->last_ins];
+                    int32_t x, y; memcpy(&x, r->out->data + r->last_ins + 5, 4); memcpy(&y, r->out->data + r->last_ins + 9, 4);
+                    int bop = -1; int32_t p = x, q = y;
+                    if(op==OP_JZ) switch(cop){
+                        case R_LT: bop = R_JLE; p = y; q = x; break;   // !(x<y)  <=> y<=x
+                        case R_LE: bop = R_JLT; p = y; q = x; break;   // !(x<=y) <=> y<x
+                        case R_GT: bop = R_JLE; break;                 // !(x>y)  <=> x<=y
+                        case R_GE: bop = R_JLT; break;                 // !(x>=y) <=> x<y
+                        case R_EQ: bop = R_JNE; break;
+                        case R_NE: bop = R_JEQ; break;
+                        default: break;
+                    } else switch(cop){
+                        case R_LT: bop = R_JLT; break;
+                        case R_LE: bop = R_JLE; break;
+                        case R_GT: bop = R_JLT; p = y; q = x; break;
+                        case R_GE: bop = R_JLE; p = y; q = x; break;
+                        case R_EQ: bop = R_JEQ; break;
+                        case R_NE: bop = R_JNE; break;
+                        default: break;
+                    }
+                    if(bop >= 0){
+                        r->out->len = r->last_ins;
+                        flush(r);
+                        ins(r, bop); cb_w32(r->out, p); cb_w32(r->out, q); jump_to(r, tgt);
+                        break;
+                    }
+                }
+                int rc = opnd(r, c);
+                flush(r);
+                if(op==OP_JZ){ ins(r, R_JZ); cb_w32(r->out, rc); }
+                else { int z = const_reg(r, SV_INT, 0); ins(r, R_JNE); cb_w32(r->out, rc); cb_w32(r->out, z); }
+                jump_to(r, tgt);
+            } break;
+            case OP_LOAD_LOAD_LT_JZ:
+                flush(r);
+                ins(r, R_JLE); cb_w32(r->out, rd32(a+4)); cb_w32(r->out, rd32(a));
+                jump_to(r, (uint32_t)((int64_t)next + rd32(a+8)));
+                break;
+            case OP_PRINT: case OP_PRINTLN: {
+                SymVal v = r->stk[--r->sp];
+                int ra = opnd(r, v);
+                ins(r, op==OP_PRINT ? R_PRINT : R_PRINTLN); cb_w32(r->out, ra);
+            } break;
+            case OP_HALT:
+                ins(r, R_HALT);
+                break;
+            default: { // ADD..OR
+                SymVal b = r->stk[--r->sp], x = r->stk[--r->sp];
+                int ra = opnd(r, x), rb = opnd(r, b);
+                alu(r, op - OP_ADD + R_ADD, ra, rb);
+            } break;
+        }
+        if(op==OP_JMP || op==OP_HALT) r->sp = 0;
+        pc = next;
+    }
+    flush(r);
+    r->map[r->len] = r->out->len;
+}
+
+int reg_translate(const uint8_t* code, size_t len, int nslots,
+                  CodeBuf* out, uint32_t* nregs){
+    RA r; memset(&r, 0, sizeof(r));
+    r.code = code; r.len = len; r.nslots = nslots; r.last_dst = -1;
+    r.depth = (int32_t*)malloc((len + 1) * sizeof(int32_t));
+    r.map   = (size_t*)calloc(len + 1, sizeof(size_t));
+    if(!r.depth || !r.map) abort();
+    for(size_t i=0;i<=len;i++) r.depth[i] = -1;
+    int ok = scan(&r);
+    if(ok){
+        r.stk = (SymVal*)calloc((size_t)r.ntemps + 1, sizeof(SymVal));
+        if(!r.stk) abort();
+        CodeBuf body; cb_init(&body);
+        r.out = &body;
+        emit_body(&r);
+        for(size_t i=0;i<r.nfix;i++)
+            put32(&body, r.fixes[i].pos, (int32_t)((int64_t)r.map[r.fixes[i].target] - (int64_t)(r.fixes[i].pos + 4)));
+        // Prolog: Konstantenregister laden; Sprünge sind relativ, daher
+        // verschiebt sich durch das Voranstellen nichts.
+        for(int i=0;i<r.nconst;i++){
+            cb_w8(out, r.consts[i].kind==SV_INT ? R_MOVI : R_MOVS);
+            cb_w32(out, nslots + r.ntemps + i);
+            cb_w32(out, r.consts[i].v);
+        }
+        for(size_t i=0;i<body.len;i++) cb_w8(out, body.data[i]);
+        cb_free(&body);
+        *nregs = (uint32_t)(nslots + r.ntemps + r.nconst);
+    }
+    free(r.depth); free(r.map); free(r.fixes); free(r.consts); free(r.stk);
+    return ok;
+}
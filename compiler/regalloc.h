@@ -0,0 +1,14 @@
+#ifndef NOVA_REGALLOC_H
+#define NOVA_REGALLOC_H
+#include <stdint.h>
+#include <stddef.h>
+#include "emit.h"
+
+// Übersetzt fertigen Stack-Bytecode in den Register-Flavour (Drei-Adress-Code).
+// Registerbelegung: [0,nslots) Variablen, danach ein Temporary je Stacktiefe,
+// danach Konstanten. Liefert 0, wenn der Code Konstrukte enthält, die das
+// Registerbackend noch nicht abdeckt (Funktionen: CALL/RET/ARG).
+int reg_translate(const uint8_t* code, size_t len, int nslots,
+                  CodeBuf* out, uint32_t* nregs);
+
+#endif
@@ -1,64 +1,62 @@
 #include "symtab.h"
 #include <string.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <stdint.h>
 
-#define NOVA_MAX_SLOTS   256
-#define NOVA_MAX_SYMBOLS 1024
-
-typedef struct {
-    char     name[64];
-    uint8_t  slot;
+struct SymEnt {
+    int      name;     // interned id
+    int      slot;
     int      depth;
-    int      in_use;
-} SymEnt;
+    int      prev;     // vorherige sichtbare Deklaration desselben Namens, -1
+};
 
-static SymEnt g_symbols[NOVA_MAX_SYMBOLS];
-static int    g_sym_count = 0;
-static int    g_scope_depth = 0;
-static int    g_next_slot   = 0;
+void sym_init(SymTab* st, Arena* a){
+    memset(st, 0, sizeof(*st));
+    st->arena = a;
+}
 
-void sym_reset(void){
-    memset(g_symbols, 0, sizeof(g_symbols));
-    g_sym_count=0; g_scope_depth=0; g_next_slot=0;
+void sym_reset(SymTab* st){
+    while(st->count > 0){ SymEnt* e = &st->symbols[--st->count]; st->head[e->name] = e->prev; }
+    st->depth = 0; st->next_slot = 0;
 }
 
-void scope_push(void){ g_scope_depth++; }
+void scope_push(SymTab* st){ st->depth++; }
 
-void scope_pop(void){
-    for (int i=g_sym_count-1; i>=0; --i){
-        if (g_symbols[i].in_use && g_symbols[i].depth == g_scope_depth){
-            g_symbols[i].in_use = 0;
-        }
+void scope_pop(SymTab* st){
+    // Deklarationen liegen nach Tiefe sortiert, die innersten zuoberst
+    while (st->count > 0 && st->symbols[st->count-1].depth == st->depth){
+        SymEnt* e = &st->symbols[--st->count];
+        st->head[e->name] = e->prev;
     }
-    g_scope_depth--;
-    if (g_scope_depth < 0) g_scope_depth = 0;
+    st->depth--;
+    if (st->depth < 0) st->depth = 0;
 }
 
-int sym_lookup_slot(const char* name){
-    for (int i=g_sym_count-1; i>=0; --i){
-        if (g_symbols[i].in_use && strcmp(g_symbols[i].name, name) == 0){
-            return g_symbols[i].slot;
-        }
-    }
-    return -1;
+int sym_lookup_slot(const SymTab* st, int name){
+    if (name < 0 || name >= st->head_cap || st->head[name] < 0) return -1;
+    return st->symbols[st->head[name]].slot;
 }
 
-int sym_declare(const char* name){
-    if (g_next_slot >= NOVA_MAX_SLOTS){
-        fprintf(stderr, "out of variable slots (max %d)\n", NOVA_MAX_SLOTS);
-        exit(1);
+int sym_declare(SymTab* st, int name){
+    if (st->next_slot >= NOVA_MAX_SLOTS) return -1;
+    if (name >= st->head_cap){
+        int ncap = st->head_cap ? st->head_cap : 256;
+        while (ncap <= name) ncap *= 2;
+        st->head = (int*)arena_grow(st->arena, st->head, (size_t)st->head_cap * sizeof(int), (size_t)ncap * sizeof(int));
+        for (int i = st->head_cap; i < ncap; i++) st->head[i] = -1;
+        st->head_cap = ncap;
     }
-    if (g_sym_count >= NOVA_MAX_SYMBOLS){
-        fprintf(stderr, "symbol table full (max %d)\n", NOVA_MAX_SYMBOLS);
-        exit(1);
+    if (st->count == st->cap){
+        int ncap = st->cap ? st->cap*2 : 256;
+        st->symbols = (SymEnt*)arena_grow(st->arena, st->symbols, (size_t)st->cap * sizeof(SymEnt), (size_t)ncap * sizeof(SymEnt));
+        st->cap = ncap;
     }
-    SymEnt* e = &g_symbols[g_sym_count++];
-    memset(e, 0, sizeof(*e));
-    strncpy(e->name, name, sizeof(e->name)-1);
-    e->slot  = (uint8_t)g_next_slot++;
-    e->depth = g_scope_depth;
-    e->in_use= 1;
+    SymEnt* e = &st->symbols[st->count];
+    e->name  = name;
+    e->slot  = st->next_slot++;
+    e->depth = st->depth;
+    e->prev  = st->head[name];
+    st->head[name] = st->count++;
     return e->slot;
 }
+
+int sym_slot_count(const SymTab* st){ return st->next_slot; }
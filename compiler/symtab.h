@@ -1,18 +1,38 @@
 #ifndef NOVA_SYMTAB_H
 #define NOVA_SYMTAB_H
 
-// Simple symbol table API for future use.
-// Current novac.c does not depend on this yet; it's provided for gradual refactor.
+// Block-scoped symbol table for function locals (parameters + let).
+// novac calls sym_reset() per function; slots are frame-relative and never
+// reused within a function, so sym_slot_count() is the frame size.
+// Names are interned ids (see intern.h); lookup is O(1) via a per-id chain
+// of visible declarations. One table per compilation (no globals); tables
+// live in the arena passed to sym_init.
+#include "arena.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void  sym_reset(void);
-void  scope_push(void);
-void  scope_pop(void);
-int   sym_lookup_slot(const char* name); // -1 if not found
-int   sym_declare(const char* name);     // returns slot index 0..255
+#define NOVA_MAX_SLOTS   256   // Locals je Frame (VM_MAX_LOCALS)
+
+typedef struct SymEnt SymEnt;
+typedef struct {
+    Arena*  arena;
+    SymEnt* symbols;       // Deklarationen in Reihenfolge (Stack)
+    int     count, cap;
+    int*    head;          // name id -> jüngste sichtbare Deklaration, -1
+    int     head_cap;
+    int     depth;         // aktuelle Blocktiefe
+    int     next_slot;
+} SymTab;
+
+void  sym_init(SymTab* st, Arena* a);
+void  sym_reset(SymTab* st);
+void  scope_push(SymTab* st);
+void  scope_pop(SymTab* st);
+int   sym_lookup_slot(const SymTab* st, int name); // -1 if not found
+int   sym_declare(SymTab* st, int name);           // slot index 0..255, -1 if the frame is full
+int   sym_slot_count(const SymTab* st);            // slots declared since sym_reset
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,121 @@
+// compile_threads - libnovac: N Compiler auf N Threads übersetzen dieselben
+// Quellen immer wieder. Jedes Ergebnis muss byte-gleich zu einer einmaligen
+// Übersetzung sein, Fehler kommen mit Zeile zurück (ohne exit) und lassen den
+// Compiler benutzbar, und nach dem ersten Durchlauf wird der Ausgabepuffer
+// wiederverwendet. Zum Schluss läuft ein im Speicher übersetztes Programm auf
+// libnovavm.
+//
+//   compile_threads <threads> <a.nova> [b.nova ...]
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "novac.h"
+#include "novavm.h"
+
+#define ROUNDS 50
+
+typedef struct { char* src; size_t len; NovaBytecode ref; } Source;
+
+static Source* g_src;
+static int     g_nsrc;
+
+static const char bad_src[] = "let a = 1\nlet b = (a +\nprintln(b)\n";
+
+typedef struct { int ok; char why[160]; } Job;
+
+static void* worker(void* arg){
+    Job* j = (Job*)arg;
+    NovaCompiler* c = nova_compiler_new(NULL);
+    NovaBytecode bc = {0};
+    NovaDiag d;
+    if(!c){ snprintf(j->why, sizeof(j->why), "nova_compiler_new failed"); return NULL; }
+    const uint8_t* buf = NULL;
+    for(int r = 0; r < ROUNDS; r++){
+        for(int i = 0; i < g_nsrc; i++){
+            if(!nova_compiler_compile(c, g_src[i].src, g_src[i].len, &bc, &d) ||
+               bc.len != g_src[i].ref.len || memcmp(bc.data, g_src[i].ref.data, bc.len) != 0){
+                snprintf(j->why, sizeof(j->why), "round %d, source %d: output differs", r, i);
+                goto out;
+            }
+            if(r == 1 && i == 0) buf = bc.data;
+        }
+        // Fehler mitten in der Runde: Meldung mit Zeile, danach geht es normal weiter
+        if(nova_compiler_compile(c, bad_src, sizeof(bad_src) - 1, &bc, &d) || d.line != 3 || bc.len != 0){
+            snprintf(j->why, sizeof(j->why), "round %d: bad source: line %d, %s", r, d.line, d.msg);
+            goto out;
+        }
+    }
+    if(bc.data != buf){ snprintf(j->why, sizeof(j->why), "output buffer was reallocated"); goto out; }
+    j->ok = 1;
+out:
+    nova_bytecode_free(&bc);
+    nova_compiler_free(c);
+    return NULL;
+}
+
+static void buf_write(void* user, const char* data, size_t len){
+    strncat((char*)user, data, len < 63 - strlen((char*)user) ? len : 63 - strlen((char*)user));
+}
+
+static char* read_file(const char* path, size_t* len){
+    FILE* f = fopen(path, "rb");
+    if(!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* s = n >= 0 ? (char*)malloc((size_t)n) : NULL;
+    if(s && fread(s, 1, (size_t)n, f) != (size_t)n){ free(s); s = NULL; }
+    fclose(f);
+    *len = (size_t)n;
+    return s;
+}
+
+int main(int argc, char** argv){
+    if(argc < 3){ fprintf(stderr, "usage: %s <threads> <a.nova> [b.nova ...]\n", argv[0]); return 2; }
+    int n = atoi(argv[1]);
+    if(n < 1 || n > 256) n = 8;
+    g_nsrc = argc - 2;
+    g_src = (Source*)calloc((size_t)g_nsrc, sizeof(Source));
+    NovaDiag d;
+    for(int i = 0; i < g_nsrc; i++){
+        // Quelle ohne NUL am Ende: der Compiler darf nur len Bytes lesen
+        g_src[i].src = read_file(argv[i + 2], &g_src[i].len);
+        if(!g_src[i].src){ fprintf(stderr, "cannot read %s\n", argv[i + 2]); return 1; }
+        if(!nova_compile(g_src[i].src, g_src[i].len, &g_src[i].ref, &d)){
+            fprintf(stderr, "%s: line %d: %s\n", argv[i + 2], d.line, d.msg);
+            return 1;
+        }
+    }
+
+    Job* jobs = (Job*)calloc((size_t)n, sizeof(Job));
+    pthread_t* th = (pthread_t*)calloc((size_t)n, sizeof(pthread_t));
+    for(int i = 0; i < n; i++)
+        if(pthread_create(&th[i], NULL, worker, &jobs[i]) != 0){ fprintf(stderr, "pthread_create failed\n"); return 1; }
+    int ok = 1;
+    for(int i = 0; i < n; i++){
+        pthread_join(th[i], NULL);
+        if(!jobs[i].ok){ fprintf(stderr, "compile_threads: thread %d: %s\n", i, jobs[i].why); ok = 0; }
+    }
+
+    // Quelltext -> Image -> VM, ohne Datei
+    static const char prog[] = "func sq(x) { return x * x }\nprintln(sq(7) + 2)\n";
+    NovaBytecode bc = {0};
+    char out[64] = "", err[128] = "";
+    NovaProgram* pr = nova_compile(prog, sizeof(prog) - 1, &bc, &d) ? nova_program_load_mem(bc.data, bc.len, err, sizeof(err)) : NULL;
+    NovaVM* vm = pr ? nova_vm_new(pr) : NULL;
+    if(vm){
+        nova_vm_set_output(vm, buf_write, out, 0);
+        if(nova_vm_run(vm, 0) != NOVA_DONE) out[0] = 0;
+    }
+    if(strcmp(out, "51\n") != 0){ fprintf(stderr, "compile_threads: in-memory run: '%s' %s\n", out, err); ok = 0; }
+    nova_vm_free(vm);
+    nova_program_free(pr);
+    nova_bytecode_free(&bc);
+
+    if(ok) printf("compile_threads: ok (%d threads, %d sources, %d rounds)\n", n, g_nsrc, ROUNDS);
+    for(int i = 0; i < g_nsrc; i++){ free(g_src[i].src); nova_bytecode_free(&g_src[i].ref); }
+    free(g_src); free(jobs); free(th);
+    return ok ? 0 : 1;
+}
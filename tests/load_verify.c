@@ -0,0 +1,104 @@
+// load_verify - libnovavm: handgebaute v1-Images mit kaputtem Stackverhalten
+// muss nova_program_load_mem mit passender Meldung ablehnen (statt sie später
+// in der Dispatch-Schleife auszuführen); gültige Gegenstücke laden und laufen.
+//
+//   load_verify
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "novavm.h"
+#include "opcodes.h"
+
+typedef struct { uint8_t b[256]; size_t n; } Img;
+
+static void put8(Img* im, int v){ im->b[im->n++] = (uint8_t)v; }
+static void put32(Img* im, int32_t v){ for(int i = 0; i < 4; i++) put8(im, (int)(((uint32_t)v >> (8*i)) & 0xff)); }
+static void op(Img* im, int o){ put8(im, o); }
+static void op1(Img* im, int o, int32_t a){ put8(im, o); put32(im, a); }
+static void op2(Img* im, int o, int32_t a, int32_t b){ put8(im, o); put32(im, a); put32(im, b); }
+
+/* "NOVABC01", keine Strings, Code aus c */
+static size_t image(uint8_t* out, const Img* c){
+    memcpy(out, "NOVABC01", 8);
+    memset(out + 8, 0, 4);
+    for(int i = 0; i < 4; i++) out[12 + i] = (uint8_t)((c->n >> (8*i)) & 0xff);
+    memcpy(out + 16, c->b, c->n);
+    return 16 + c->n;
+}
+
+static void buf_write(void* user, const char* data, size_t len){
+    strncat((char*)user, data, len < 63 - strlen((char*)user) ? len : 63 - strlen((char*)user));
+}
+
+static int g_fail, g_count;
+
+/* expect == NULL: muss laden und out ausgeben, sonst mit expect abgelehnt werden */
+static void check(const char* name, const Img* c, const char* expect, const char* out){
+    uint8_t buf[512];
+    char err[128] = "", got[64] = "";
+    size_t len = image(buf, c);
+    NovaProgram* pr = nova_program_load_mem(buf, len, err, sizeof(err));
+    g_count++;
+    if(expect){
+        if(pr || !strstr(err, expect)){
+            fprintf(stderr, "load_verify: %s: expected '%s', got %s '%s'\n", name, expect, pr ? "loaded" : "error", err);
+            g_fail++;
+        }
+    } else if(!pr){
+        fprintf(stderr, "load_verify: %s: rejected: %s\n", name, err);
+        g_fail++;
+    } else {
+        NovaVM* vm = nova_vm_new(pr);
+        nova_vm_set_output(vm, buf_write, got, 64);
+        int rc = nova_vm_run(vm, 0);
+        if(rc != NOVA_DONE || strcmp(got, out) != 0){
+            fprintf(stderr, "load_verify: %s: exit %d, output '%s' (%s)\n", name, rc, got, nova_vm_error(vm));
+            g_fail++;
+        }
+        nova_vm_free(vm);
+    }
+    nova_program_free(pr);
+}
+
+int main(void){
+    Img c;
+    // gültig: f(x) = x + 1, println(f(41))
+    c.n = 0; op1(&c, OP_PUSHI, 41); op2(&c, OP_CALL, 16, 1); op(&c, OP_PRINTLN); op(&c, OP_HALT);
+    op1(&c, OP_LOAD_LOCAL, 0); op1(&c, OP_PUSHI, 1); op(&c, OP_ADD); op1(&c, OP_RET, 1);
+    check("call", &c, NULL, "42\n");
+
+    c.n = 0; op1(&c, OP_PUSHI, 1); op(&c, OP_ADD); op(&c, OP_HALT);
+    check("underflow", &c, "stack underflow at pc=5", NULL);
+
+    c.n = 0; op(&c, OP_POP);
+    check("underflow_pop", &c, "stack underflow at pc=0", NULL);
+
+    // if(1) push 2: Zusammenführung mit Tiefe 0 und 1
+    c.n = 0; op1(&c, OP_PUSHI, 1); op1(&c, OP_JZ, 5); op1(&c, OP_PUSHI, 2); op(&c, OP_HALT);
+    check("join", &c, "inconsistent stack depth", NULL);
+
+    // Schleife, die bei jedem Durchlauf einen Wert liegen lässt
+    c.n = 0; op1(&c, OP_PUSHI, 1); op1(&c, OP_JMP, -10);
+    check("loop_grows", &c, "inconsistent stack depth at pc=5", NULL);
+
+    c.n = 0; op1(&c, OP_PUSHI, 1); op1(&c, OP_RET, 1);
+    check("ret_main", &c, "return outside function at pc=5", NULL);
+
+    // Hauptprogramm läuft hinter dem CALL in den Funktionsrumpf
+    c.n = 0; op2(&c, OP_CALL, 9, 0); op1(&c, OP_RET, 0);
+    check("fallthrough", &c, "jump into another function", NULL);
+
+    // dieselbe Funktion mit 0 und 1 Argument
+    c.n = 0; op2(&c, OP_CALL, 25, 0); op(&c, OP_POP); op1(&c, OP_PUSHI, 1); op2(&c, OP_CALL, 25, 1); op(&c, OP_HALT);
+    op1(&c, OP_RET, 0);
+    check("argc", &c, "inconsistent stack depth", NULL);
+
+    // Local 0 ohne Parameter und ENTER
+    c.n = 0; op2(&c, OP_CALL, 10, 0); op(&c, OP_HALT); op1(&c, OP_LOAD_LOCAL, 0); op1(&c, OP_RET, 1);
+    check("local", &c, "bad local 0 at pc=10", NULL);
+
+    if(g_fail) return 1;
+    printf("load_verify: ok (%d images)\n", g_count);
+    return 0;
+}
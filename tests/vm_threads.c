@@ -0,0 +1,104 @@
+// vm_threads - N VM-Instanzen auf N Threads über einem einmal geladenen
+// Program. Jede Instanz muss dieselbe Ausgabe wie ein Einzellauf liefern
+// (verschieden ausgeführt: interpretiert, mit JIT, in Budget-Schritten), und
+// das Program darf sich dabei nicht ändern: Code und Stringpool werden
+// geteilt, nicht kopiert.
+//
+//   vm_threads <program.nvc> [threads]
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "novavm.h"
+#include "program.h"
+
+typedef struct { char* p; size_t len, cap; } Buf;
+
+static void buf_write(void* user, const char* data, size_t len){
+    Buf* b = (Buf*)user;
+    if(b->len + len > b->cap){
+        b->cap = (b->len + len) * 2;
+        b->p = (char*)realloc(b->p, b->cap);
+        if(!b->p){ fprintf(stderr, "oom\n"); exit(1); }
+    }
+    memcpy(b->p + b->len, data, len);
+    b->len += len;
+}
+
+typedef struct {
+    const NovaProgram* pr;
+    int   mode;            // 0 interpretiert, 1 JIT, 2 Budget-Schritte
+    int   rounds;
+    Buf   out;
+    int   rc;
+} Job;
+
+static void* worker(void* arg){
+    Job* j = (Job*)arg;
+    NovaVM* vm = nova_vm_new(j->pr);
+    if(!vm){ j->rc = -1; return NULL; }
+    nova_vm_set_output(vm, buf_write, &j->out, 256);
+    if(j->mode == 1) nova_vm_set_jit(vm, NOVA_JIT_ALWAYS);
+    // mehrere Läufe je Instanz: jeder beginnt mit frischen Globals/Arrays
+    for(int r = 0; r < j->rounds; r++){
+        j->out.len = 0;
+        if(j->mode == 2) while((j->rc = nova_vm_run(vm, 1000)) == NOVA_SUSPENDED) {}
+        else j->rc = nova_vm_run(vm, 0);
+    }
+    nova_vm_free(vm);
+    return NULL;
+}
+
+static uint64_t fnv(const void* p, size_t n, uint64_t h){
+    const unsigned char* c = (const unsigned char*)p;
+    for(size_t i = 0; i < n; i++) h = (h ^ c[i]) * 1099511628211u;
+    return h;
+}
+static uint64_t program_hash(const Program* pr){
+    uint64_t h = fnv(pr->insns, ((size_t)pr->ninsns + 1) * sizeof(Insn), 14695981039346656037u);
+    h = fnv(pr->strs, pr->nstrs * sizeof(char*), h);
+    return fnv(pr->image, pr->image_len, h);
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){ fprintf(stderr, "usage: %s <program.nvc> [threads]\n", argv[0]); return 2; }
+    int n = argc > 2 ? atoi(argv[2]) : 8;
+    if(n < 1 || n > 256) n = 8;
+    char err[256] = "";
+    NovaProgram* pr = nova_program_load_file(argv[1], err, sizeof(err));
+    if(!pr){ fprintf(stderr, "%s\n", err); return 1; }
+
+    // v2-Images: Strings zeigen direkt ins (einmal) eingeblendete Image
+    const char* img = (const char*)pr->image;
+    int shared = 1;
+    for(uint32_t i = 0; i < pr->nstrs; i++)
+        if(!pr->strblob && (pr->strs[i] < img || pr->strs[i] >= img + pr->image_len)) shared = 0;
+    if(!shared){ fprintf(stderr, "vm_threads: string pool not in the program image\n"); return 1; }
+
+    uint64_t h0 = program_hash(pr);
+    Job ref = { pr, 0, 1, {0}, 0 };
+    worker(&ref);
+
+    Job* jobs = (Job*)calloc((size_t)n, sizeof(Job));
+    pthread_t* th = (pthread_t*)calloc((size_t)n, sizeof(pthread_t));
+    if(!jobs || !th){ fprintf(stderr, "oom\n"); return 1; }
+    for(int i = 0; i < n; i++){
+        jobs[i].pr = pr; jobs[i].mode = i % 3; jobs[i].rounds = 3;
+        if(pthread_create(&th[i], NULL, worker, &jobs[i]) != 0){ fprintf(stderr, "pthread_create failed\n"); return 1; }
+    }
+    int ok = 1;
+    for(int i = 0; i < n; i++){
+        pthread_join(th[i], NULL);
+        if(jobs[i].rc != ref.rc || jobs[i].out.len != ref.out.len || memcmp(jobs[i].out.p, ref.out.p, ref.out.len) != 0){
+            fprintf(stderr, "vm_threads: instance %d (mode %d) differs: exit %d, %zu bytes\n", i, jobs[i].mode, jobs[i].rc, jobs[i].out.len);
+            ok = 0;
+        }
+        free(jobs[i].out.p);
+    }
+    if(program_hash(pr) != h0){ fprintf(stderr, "vm_threads: program modified during runs\n"); ok = 0; }
+    if(ok) printf("vm_threads: ok (%d instances, %zu bytes, exit %d)\n", n, ref.out.len, ref.rc);
+    free(ref.out.p); free(jobs); free(th);
+    nova_program_free(pr);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#ifndef NOVA_JIT_H
+#define NOVA_JIT_H
+// Template-JIT für Stack-Bytecode (x86-64, System-V-ABI).
+//
+// Der Interpreter meldet Back-Edges (JMP rückwärts) und CALL-Ziele über
+// jit_hot(). Überschreitet ein Zähler die Schwelle, wird die Region
+// (Schleife: Ziel..Back-Edge, Funktion: Einsprung..letztes RET) als
+// nativer Code in ausführbaren mmap-Speicher kopiert. Nativer Code arbeitet
+// direkt auf vars/Stack der VM und kehrt mit dem Index der nächsten vom
+// Interpreter auszuführenden Instruktion zurück: beim Verlassen der Region
+// und bei allem, was er nicht selbst kann (CALL, RET, HALT, Division durch
+// 0 - der Interpreter führt die Instruktion dann erneut aus und meldet den
+// Fehler wie gewohnt). Ein TAILCALL auf eine Instruktion der Region wird
+// zum direkten Sprung; Endrekursion läuft so als Schleife.
+// Nativer Code vergrößert den Wertestack nie (JitCtx.stack bleibt gültig):
+// den Bedarf der Funktion (Insn.c) hat der Interpreter beim CALL reserviert.
+#include <stdint.h>
+#include "program.h"
+
+enum { JIT_OFF=0, JIT_ON, JIT_ALWAYS };
+
+// Zustand, den nativer Code liest und schreibt (Offsets sind im
+// Codegenerator fest verdrahtet)
+typedef struct JitCtx {
+    Value*         vars;   // +0
+    Value*         stack;  // +8
+    int32_t        sp;     // +16  Index des nächsten freien Stackeintrags
+    int32_t        fp;     // +20  Frame-Basis (OP_LOAD_LOCAL)
+    const Program* pr;     // +24  für PRINT
+    int32_t        scap;   // +32  Größe des Wertestacks (OP_TAILCALL)
+    struct Out*    out;    // +40  Ausgabe der VM-Instanz (PRINT)
+} JitCtx;
+
+typedef int32_t (*JitFn)(JitCtx* cx);
+
+typedef struct Jit Jit;
+
+int   jit_available(void);
+Jit*  jit_new(const Program* pr, int mode);   // NULL bei JIT_OFF oder ohne Backend
+void  jit_free(Jit* j);
+// Zählt einen Eintritt bei Instruktion idx; liefert nativen Code, sobald vorhanden
+JitFn jit_hot(Jit* j, uint32_t idx, int is_call);
+
+#endif
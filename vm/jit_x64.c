@@ -0,0 +1,503 @@
+// vm/jit_x64.c - Template-JIT für x86-64 (siehe jit.h)
+//
+// Registerbelegung im erzeugten Code:
+//   rbx = vars, r12 = Stackbasis, r13 = nächster freier Stackeintrag,
+//   r14 = Frame-Basis (stack + fp), r15 = JitCtx*
+// Der Operandenstack bleibt im Speicher; jede Instruktion wird durch eine
+// feste Schablone ersetzt, Sprünge innerhalb der Region werden direkte
+// Sprünge, alle anderen enden in einem Exit-Stub (eax = Instruktionsindex).
+// Werte sind 64-Bit-Wörter (value.h); Arithmetik prüft per Tag-Test, ob
+// beide Operanden Integer sind, und verlässt sonst die Region - der
+// Interpreter nimmt dann den langsamen Pfad.
+#include "jit.h"
+#include "opcodes.h"
+#include "out.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define NOVA_JIT_X64 1
+#include <sys/mman.h>
+#endif
+
+#define JIT_THRESHOLD   1000
+#define JIT_MAX_REGION  65536
+
+struct Jit {
+    const Program* pr;
+    int        mode;
+    uint32_t*  counters;  // je Instruktion
+    JitFn*     entry;     // nativer Einsprung je Instruktion
+    uint8_t*   failed;    // Region ließ sich nicht übersetzen
+    int        popcnt;    // CPU hat POPCNT
+    void**     maps; size_t* map_sizes; size_t nmaps, capmaps;
+};
+
+#ifdef NOVA_JIT_X64
+
+int jit_available(void){ return 1; }
+
+// Laufzeithilfe für PRINT/PRINTLN; 1 = ungültige String-Id (der Interpreter
+// meldet den Fehler dann selbst)
+static int jit_print(JitCtx* cx, Value v, int newline){
+    return vm_print(cx->out, cx->pr, v, newline);
+}
+
+// ---- Code-Puffer ----
+enum { FX_LABEL, FX_EXIT };
+typedef struct { size_t pos; int kind; uint32_t idx; } Fix;
+
+typedef struct {
+    uint8_t* buf; size_t len, cap;
+    Fix* fix; size_t nfix, capfix;
+} Asm;
+
+static void put(Asm* a, const void* p, size_t n){
+    if(a->len + n > a->cap){
+        size_t nc = a->cap ? a->cap*2 : 4096;
+        while(nc < a->len + n) nc *= 2;
+        a->buf = (uint8_t*)realloc(a->buf, nc);
+        if(!a->buf) abort();
+        a->cap = nc;
+    }
+    memcpy(a->buf + a->len, p, n); a->len += n;
+}
+static void b1(Asm* a, uint8_t x){ put(a, &x, 1); }
+static void i32(Asm* a, int32_t x){ put(a, &x, 4); }
+#define BYTES(a, ...) do { static const uint8_t _b[] = { __VA_ARGS__ }; put((a), _b, sizeof(_b)); } while(0)
+
+enum { RAX=0, RCX=1, RDX=2, RBX=3, RSI=6, RDI=7, R12=12, R13=13, R14=14, R15=15 };
+
+// <opc> reg, [base + disp32]  (immer mod=10, SIB für rsp/r12 als Basis)
+static void mem(Asm* a, int w, const uint8_t* opc, int nopc, int reg, int base, int32_t disp){
+    uint8_t rex = (uint8_t)(0x40 | (w<<3) | ((reg>>3)<<2) | (base>>3));
+    if(rex != 0x40) b1(a, rex);
+    put(a, opc, (size_t)nopc);
+    b1(a, (uint8_t)(0x80 | ((reg&7)<<3) | (base&7)));
+    if((base&7) == 4) b1(a, 0x24);
+    i32(a, disp);
+}
+static const uint8_t MOV_LD[] = {0x8B}, MOV_ST[] = {0x89}, ADD_ST[] = {0x01}, SUB_ST[] = {0x29},
+                     AND_ST[] = {0x21}, OR_ST[] = {0x09}, XOR_ST[] = {0x31}, CMP_LD[] = {0x3B},
+                     MOV_IMM[] = {0xC7}, GRP3[] = {0xF7}, SHIFT_IMM[] = {0xC1}, LEA[] = {0x8D};
+
+// Alle Werte 64 Bit: Slot k liegt bei 8*k, Stackspitze bei [r13-8]
+static void ld(Asm* a, int reg, int base, int32_t d){ mem(a, 1, MOV_LD, 1, reg, base, d); }
+static void st(Asm* a, int reg, int base, int32_t d){ mem(a, 1, MOV_ST, 1, reg, base, d); }
+static void push_rax(Asm* a){ st(a, RAX, R13, 0); BYTES(a, 0x49,0x83,0xC5,0x08); }  // add r13,8
+static void drop(Asm* a){ BYTES(a, 0x49,0x83,0xED,0x08); }                           // sub r13,8
+static void mov_imm(Asm* a, int reg, int64_t v){
+    b1(a, (uint8_t)(0x48 | (reg>>3)));
+    if((int32_t)v == v){ int32_t s = (int32_t)v; b1(a, 0xC7); b1(a, (uint8_t)(0xC0 | (reg&7))); put(a, &s, 4); } // mov r64, simm32
+    else { b1(a, (uint8_t)(0xB8 | (reg&7))); put(a, &v, 8); }                                              // mov r64, imm64
+}
+
+static void jump(Asm* a, const uint8_t* opc, int nopc, int kind, uint32_t idx){
+    put(a, opc, (size_t)nopc);
+    if(a->nfix == a->capfix){
+        a->capfix = a->capfix ? a->capfix*2 : 64;
+        a->fix = (Fix*)realloc(a->fix, a->capfix * sizeof(Fix));
+        if(!a->fix) abort();
+    }
+    a->fix[a->nfix].pos = a->len; a->fix[a->nfix].kind = kind; a->fix[a->nfix].idx = idx; a->nfix++;
+    i32(a, 0);
+}
+static const uint8_t JMP[] = {0xE9}, JE[] = {0x0F,0x84}, JNE[] = {0x0F,0x85}, JGE[] = {0x0F,0x8D}, JA[] = {0x0F,0x87},
+                     JBE[] = {0x0F,0x86}, JO[] = {0x0F,0x80}, JAE[] = {0x0F,0x83};
+
+// Sprung auf Instruktion t: intern, wenn t in [lo,hi], sonst Exit
+static void jump_to(Asm* a, const uint8_t* opc, int nopc, uint32_t t, uint32_t lo, uint32_t hi){
+    jump(a, opc, nopc, (t >= lo && t <= hi) ? FX_LABEL : FX_EXIT, t);
+}
+
+// Kein Integer in rax (bzw. rax|rcx): Exit vor Instruktion i
+static void guard1(Asm* a, uint32_t i){
+    BYTES(a, 0xA8,0x01);                                  // test al, 1
+    jump(a, JNE, 2, FX_EXIT, i);
+}
+static void guard2(Asm* a, uint32_t i){
+    BYTES(a, 0x48,0x89,0xC2, 0x48,0x09,0xCA, 0xF6,0xC2,0x01); // mov rdx,rax; or rdx,rcx; test dl,1
+    jump(a, JNE, 2, FX_EXIT, i);
+}
+// rax = (Zweitoberstes, Oberstes), nur Integer
+static void ld2(Asm* a, uint32_t i){
+    ld(a, RAX, R13, -16); ld(a, RCX, R13, -8); guard2(a, i);
+}
+// al = 0/1 -> bool-Wort in rax
+static void box_bool(Asm* a){
+    BYTES(a, 0x0F,0xB6,0xC0, 0x48,0x8D,0x04,0xC5); i32(a, V_TAG_BOOL); // movzx eax,al; lea rax,[rax*8+1]
+}
+// al = Wahrheitswert von rax (weder Integer 0 noch false, d.h. rax > 1)
+static void truthy(Asm* a){
+    BYTES(a, 0x48,0x83,0xF8,0x01, 0x0F,0x97,0xC0);       // cmp rax,1; seta al
+}
+// rax ist kein Array: Exit vor Instruktion i; danach rax = VArray*
+static void guard_array(Asm* a, uint32_t i){
+    BYTES(a, 0x89,0xC2, 0x83,0xE2,0x07, 0x83,0xFA,0x05);  // mov edx,eax; and edx,7; cmp edx,5
+    jump(a, JNE, 2, FX_EXIT, i);
+    BYTES(a, 0x48,0x83,0xE0,0xF8);                        // and rax, -8
+}
+// rcx = Index-Wort -> Index; außerhalb von [0, len) Exit vor Instruktion i
+static void bounds(Asm* a, uint32_t i){
+    BYTES(a, 0x48,0xD1,0xF9);                             // sar rcx, 1
+    mem(a, 1, CMP_LD, 1, RCX, RAX, (int32_t)offsetof(VArray, len)); // cmp rcx, [rax+len] (vorzeichenlos)
+    jump(a, JAE, 2, FX_EXIT, i);
+}
+static void compare(Asm* a, uint8_t setcc, uint32_t i){
+    ld2(a, i);
+    BYTES(a, 0x48,0x39,0xC8);                             // cmp rax, rcx
+    BYTES(a, 0x0F); b1(a, setcc); BYTES(a, 0xC0);         // setcc al
+    box_bool(a);
+    st(a, RAX, R13, -16); drop(a);
+}
+
+// Region [lo,hi] übersetzen; NULL bei Fehler
+static JitFn compile_region(Jit* j, uint32_t lo, uint32_t hi){
+    const Insn* code = j->pr->insns;
+    uint32_t n = hi - lo + 1;
+    size_t* label = (size_t*)malloc((size_t)n * sizeof(size_t));
+    if(!label) return NULL;
+    Asm A; memset(&A, 0, sizeof(A)); Asm* a = &A;
+
+    // Prolog: Callee-saved sichern (danach ist rsp 16-Byte-ausgerichtet)
+    BYTES(a, 0x53, 0x41,0x54, 0x41,0x55, 0x41,0x56, 0x41,0x57); // push rbx,r12..r15
+    BYTES(a, 0x49,0x89,0xFF);                                   // mov r15, rdi
+    mem(a, 1, MOV_LD, 1, RBX, R15, 0);                          // mov rbx, [r15+0]
+    mem(a, 1, MOV_LD, 1, R12, R15, 8);                          // mov r12, [r15+8]
+    BYTES(a, 0x49,0x63,0x47,0x10, 0x4D,0x8D,0x2C,0xC4);         // movsxd rax,[r15+16]; lea r13,[r12+rax*8]
+    BYTES(a, 0x49,0x63,0x47,0x14, 0x4D,0x8D,0x34,0xC4);         // movsxd rax,[r15+20]; lea r14,[r12+rax*8]
+
+    for(uint32_t i=lo; i<=hi; i++){
+        const Insn* in = &code[i];
+        label[i-lo] = A.len;
+        switch(in->op){
+            case OP_PUSHI:   mov_imm(a, RAX, V_INT(in->a)); push_rax(a); break;
+            case OP_PUSHI64: mov_imm(a, RAX, V_INT(INSN_I64(in))); push_rax(a); break;
+            case OP_PUSHSTR: mov_imm(a, RAX, V_STR(in->a)); push_rax(a); break;
+            case OP_LOAD:    ld(a, RAX, RBX, 8*in->a); push_rax(a); break;
+            case OP_LOAD_LOCAL:  ld(a, RAX, R14, 8*in->a); push_rax(a); break;
+            case OP_STORE_LOCAL: ld(a, RAX, R13, -8); st(a, RAX, R14, 8*in->a); drop(a); break;
+            case OP_ENTER:
+                // Platz für die Locals hat der CALL im Interpreter reserviert
+                for(int32_t k=0; k<in->a; k++){ mem(a, 1, MOV_IMM, 1, 0, R13, 8*k); i32(a, 0); }
+                BYTES(a, 0x49,0x81,0xC5); i32(a, 8*in->a);                   // add r13, 8n
+                break;
+            case OP_STORE:   ld(a, RAX, R13, -8); st(a, RAX, RBX, 8*in->a); drop(a); break;
+            case OP_TEE:     ld(a, RAX, R13, -8); st(a, RAX, RBX, 8*in->a); break;
+            case OP_ADD:     ld2(a, i); mem(a, 1, ADD_ST, 1, RCX, R13, -16); drop(a); break;
+            case OP_SUB:     ld2(a, i); mem(a, 1, SUB_ST, 1, RCX, R13, -16); drop(a); break;
+            // geprüft: bei Überlauf führt der Interpreter die Instruktion aus und meldet ihn
+            case OP_ADD_CHK: case OP_SUB_CHK:
+                ld2(a, i);
+                b1(a, 0x48); b1(a, in->op==OP_ADD_CHK ? 0x01 : 0x29); b1(a, 0xC8); // add/sub rax, rcx
+                jump(a, JO, 2, FX_EXIT, i);
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_MUL_CHK:
+                ld2(a, i);
+                BYTES(a, 0x48,0xD1,0xF8, 0x48,0x0F,0xAF,0xC1);   // sar rax,1; imul rax,rcx
+                jump(a, JO, 2, FX_EXIT, i);
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            // &, |, ^ direkt auf den Wörtern
+            case OP_BAND: ld2(a, i); mem(a, 1, AND_ST, 1, RCX, R13, -16); drop(a); break;
+            case OP_BOR:  ld2(a, i); mem(a, 1, OR_ST,  1, RCX, R13, -16); drop(a); break;
+            case OP_BXOR: ld2(a, i); mem(a, 1, XOR_ST, 1, RCX, R13, -16); drop(a); break;
+            case OP_LSH: case OP_RSH:
+                ld2(a, i);
+                BYTES(a, 0x48,0xD1,0xF9);                                 // sar rcx,1 (cl & 63 wie V_SHL)
+                if(in->op==OP_LSH) BYTES(a, 0x48,0xD3,0xE0);              // shl rax, cl
+                else BYTES(a, 0x48,0xD3,0xF8, 0x48,0x83,0xE0,0xFE);       // sar rax, cl; and rax, -2
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_BNOT:
+                ld(a, RAX, R13, -8); guard1(a, i);
+                BYTES(a, 0x48,0x83,0xF0,0xFE);                            // xor rax, -2
+                st(a, RAX, R13, -8);
+                break;
+            case OP_POPCNT: case OP_CTZ:
+                if(in->op==OP_POPCNT && !j->popcnt){ jump(a, JMP, 1, FX_EXIT, i); break; }
+                ld(a, RAX, R13, -8); guard1(a, i);
+                BYTES(a, 0x48,0xD1,0xF8);                                 // sar rax,1
+                if(in->op==OP_POPCNT) BYTES(a, 0xF3,0x48,0x0F,0xB8,0xC0); // popcnt rax, rax
+                else BYTES(a, 0xB9,0x40,0x00,0x00,0x00,                   // mov ecx, 64
+                              0x48,0x0F,0xBC,0xC0, 0x48,0x0F,0x44,0xC1);  // bsf rax,rax; cmovz rax,rcx
+                BYTES(a, 0x48,0x01,0xC0);                                 // add rax, rax
+                st(a, RAX, R13, -8);
+                break;
+            // Arrays: Element k liegt bei [rax + 8k + offsetof(VArray, v)]
+            case OP_ALOAD: case OP_ALOAD_NC:
+                ld(a, RAX, R13, -16); ld(a, RCX, R13, -8);
+                if(in->op==OP_ALOAD){
+                    BYTES(a, 0xF6,0xC1,0x01);                             // test cl, 1
+                    jump(a, JNE, 2, FX_EXIT, i);
+                    guard_array(a, i); bounds(a, i);
+                } else BYTES(a, 0x48,0x83,0xE0,0xF8, 0x48,0xD1,0xF9);     // and rax,-8; sar rcx,1
+                BYTES(a, 0x48,0x8B,0x44,0xC8); b1(a, (uint8_t)offsetof(VArray, v)); // mov rax, [rax+rcx*8+v]
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_ASTORE: case OP_ASTORE_NC:
+                ld(a, RAX, R13, -24); ld(a, RCX, R13, -16); ld(a, RDX, R13, -8);
+                if(in->op==OP_ASTORE){
+                    BYTES(a, 0x48,0x89,0xCE, 0x48,0x09,0xD6, 0x40,0xF6,0xC6,0x01); // mov rsi,rcx; or rsi,rdx; test sil,1
+                    jump(a, JNE, 2, FX_EXIT, i);
+                    BYTES(a, 0x89,0xC6, 0x83,0xE6,0x07, 0x83,0xFE,0x05);  // mov esi,eax; and esi,7; cmp esi,5
+                    jump(a, JNE, 2, FX_EXIT, i);
+                    BYTES(a, 0x48,0x83,0xE0,0xF8);                        // and rax, -8
+                    bounds(a, i);
+                } else {
+                    BYTES(a, 0xF6,0xC2,0x01);                             // test dl, 1
+                    jump(a, JNE, 2, FX_EXIT, i);
+                    BYTES(a, 0x48,0x83,0xE0,0xF8, 0x48,0xD1,0xF9);        // and rax,-8; sar rcx,1
+                }
+                BYTES(a, 0x48,0x89,0x54,0xC8); b1(a, (uint8_t)offsetof(VArray, v)); // mov [rax+rcx*8+v], rdx
+                BYTES(a, 0x49,0x83,0xED,0x18);                            // sub r13, 24
+                break;
+            case OP_ALEN:
+                ld(a, RAX, R13, -8); guard_array(a, i);
+                mem(a, 1, MOV_LD, 1, RAX, RAX, (int32_t)offsetof(VArray, len));
+                BYTES(a, 0x48,0x01,0xC0);                                 // add rax, rax
+                st(a, RAX, R13, -8);
+                break;
+            case OP_POP: drop(a); break;
+            case OP_MUL:
+                ld2(a, i);
+                BYTES(a, 0x48,0xD1,0xF8, 0x48,0x0F,0xAF,0xC1);   // sar rax,1; imul rax,rcx
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_DIV: case OP_MOD: case OP_DIV_CHK:
+                ld2(a, i);
+                BYTES(a, 0x48,0x85,0xC9);                        // test rcx, rcx
+                jump(a, JE, 2, FX_EXIT, i);                      // /0: Interpreter meldet
+                if(in->op==OP_DIV_CHK){                          // x / -1: Interpreter prüft V_INT_MIN
+                    BYTES(a, 0x48,0x83,0xF9,0xFE);               // cmp rcx, -2
+                    jump(a, JE, 2, FX_EXIT, i);
+                }
+                // beide Wörter in 32 Bit: 32-Bit-idiv direkt auf den Wörtern
+                // (Quotient = Wert, Rest bleibt getaggt), sonst 64 Bit
+                BYTES(a, 0x48,0x63,0xD0, 0x48,0x39,0xC2, 0x75,0x00);  // movsxd rdx,eax; cmp rdx,rax; jne wide
+                size_t w1 = A.len;
+                BYTES(a, 0x48,0x63,0xD1, 0x48,0x39,0xCA, 0x75,0x00);  // movsxd rdx,ecx; cmp rdx,rcx; jne wide
+                size_t w2 = A.len;
+                BYTES(a, 0x99, 0xF7,0xF9);                            // cdq; idiv ecx
+                if(in->op!=OP_MOD) BYTES(a, 0x48,0x63,0xC0, 0x48,0x01,0xC0); // movsxd rax,eax; add rax,rax
+                else               BYTES(a, 0x48,0x63,0xC2);             // movsxd rax,edx
+                BYTES(a, 0xEB,0x00);                                  // jmp done
+                size_t d = A.len;
+                A.buf[w1-1] = (uint8_t)(d - w1); A.buf[w2-1] = (uint8_t)(d - w2);
+                BYTES(a, 0x48,0xD1,0xF8, 0x48,0xD1,0xF9);             // wide: sar rax,1; sar rcx,1
+                BYTES(a, 0x48,0x99, 0x48,0xF7,0xF9);                  // cqo; idiv rcx
+                if(in->op==OP_MOD) BYTES(a, 0x48,0x89,0xD0);          // mov rax, rdx
+                BYTES(a, 0x48,0x01,0xC0);                             // add rax, rax
+                A.buf[d-1] = (uint8_t)(A.len - d);
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_EQ: compare(a, 0x94, i); break;
+            case OP_NE: compare(a, 0x95, i); break;
+            case OP_LT: compare(a, 0x9C, i); break;
+            case OP_LE: compare(a, 0x9E, i); break;
+            case OP_GT: compare(a, 0x9F, i); break;
+            case OP_GE: compare(a, 0x9D, i); break;
+            case OP_AND: case OP_OR:
+                ld(a, RAX, R13, -16); truthy(a); BYTES(a, 0x89,0xC6);     // mov esi, eax
+                ld(a, RAX, R13, -8);  truthy(a);
+                if(in->op==OP_AND) BYTES(a, 0x40,0x20,0xF0); else BYTES(a, 0x40,0x08,0xF0); // and/or al, sil
+                box_bool(a);
+                st(a, RAX, R13, -16); drop(a);
+                break;
+            case OP_NOT:
+                ld(a, RAX, R13, -8); truthy(a); BYTES(a, 0x34,0x01);       // xor al, 1
+                box_bool(a); st(a, RAX, R13, -8);
+                break;
+            case OP_NEG: ld(a, RAX, R13, -8); guard1(a, i); mem(a, 1, GRP3, 1, 3, R13, -8); break;           // neg qword [r13-8]
+            case OP_SHL: ld(a, RAX, R13, -8); guard1(a, i); mem(a, 1, SHIFT_IMM, 1, 4, R13, -8); b1(a, (uint8_t)in->a); break;
+            case OP_JMP: jump_to(a, JMP, 1, (uint32_t)in->a, lo, hi); break;
+            case OP_JZ:
+                ld(a, RAX, R13, -8); drop(a); BYTES(a, 0x48,0x83,0xF8,0x01);  // cmp rax, 1
+                jump_to(a, JBE, 2, (uint32_t)in->a, lo, hi);
+                break;
+            case OP_JNZ:
+                ld(a, RAX, R13, -8); drop(a); BYTES(a, 0x48,0x83,0xF8,0x01);
+                jump_to(a, JA, 2, (uint32_t)in->a, lo, hi);
+                break;
+            case OP_LOAD_LOAD_LT_JZ:
+                ld(a, RAX, RBX, 8*in->a); ld(a, RCX, RBX, 8*in->b); guard2(a, i);
+                BYTES(a, 0x48,0x39,0xC8);                                     // cmp rax, rcx
+                jump_to(a, JGE, 2, (uint32_t)in->c, lo, hi);
+                break;
+            case OP_LOCAL_LOCAL_LT_JZ:
+                ld(a, RAX, R14, 8*in->a); ld(a, RCX, R14, 8*in->b); guard2(a, i);
+                BYTES(a, 0x48,0x39,0xC8);
+                jump_to(a, JGE, 2, (uint32_t)in->c, lo, hi);
+                break;
+            case OP_LOAD_LEN_LT_JZ: case OP_LOCAL_LEN_LT_JZ: {
+                int base = in->op==OP_LOAD_LEN_LT_JZ ? RBX : R14;
+                ld(a, RAX, base, 8*in->b); guard_array(a, i);
+                mem(a, 1, MOV_LD, 1, RCX, RAX, (int32_t)offsetof(VArray, len));
+                BYTES(a, 0x48,0x01,0xC9);                                     // add rcx, rcx
+                ld(a, RAX, base, 8*in->a); guard1(a, i);
+                BYTES(a, 0x48,0x39,0xC8);                                     // cmp rax, rcx
+                jump_to(a, JGE, 2, (uint32_t)in->c, lo, hi);
+            } break;
+            case OP_LOAD_LOAD_ALOAD: case OP_LOCAL_LOCAL_ALOAD:
+            case OP_LOAD_LOAD_ALOAD_NC: case OP_LOCAL_LOCAL_ALOAD_NC: {
+                int base = (in->op==OP_LOAD_LOAD_ALOAD || in->op==OP_LOAD_LOAD_ALOAD_NC) ? RBX : R14;
+                ld(a, RAX, base, 8*in->a); ld(a, RCX, base, 8*in->b);
+                if(in->op==OP_LOAD_LOAD_ALOAD || in->op==OP_LOCAL_LOCAL_ALOAD){
+                    BYTES(a, 0xF6,0xC1,0x01);                                 // test cl, 1
+                    jump(a, JNE, 2, FX_EXIT, i);
+                    guard_array(a, i); bounds(a, i);
+                } else BYTES(a, 0x48,0x83,0xE0,0xF8, 0x48,0xD1,0xF9);         // and rax,-8; sar rcx,1
+                BYTES(a, 0x48,0x8B,0x44,0xC8); b1(a, (uint8_t)offsetof(VArray, v)); // mov rax, [rax+rcx*8+v]
+                push_rax(a);
+            } break;
+            case OP_INC_SLOT: case OP_INC_LOCAL: {
+                int base = in->op==OP_INC_SLOT ? RBX : R14;
+                ld(a, RAX, base, 8*in->a); guard1(a, i);
+                mov_imm(a, RCX, V_INT(in->b)); mem(a, 1, ADD_ST, 1, RCX, base, 8*in->a);
+            } break;
+            case OP_LOAD_PUSHI_ADD: case OP_LOAD_LOCAL_PUSHI_ADD:
+                ld(a, RAX, in->op==OP_LOAD_PUSHI_ADD ? RBX : R14, 8*in->a); guard1(a, i);
+                mov_imm(a, RCX, V_INT(in->b)); BYTES(a, 0x48,0x01,0xC8);       // add rax, rcx
+                push_rax(a);
+                break;
+            case OP_PRINT: case OP_PRINTLN: {
+                BYTES(a, 0x4C,0x89,0xFF);                                 // mov rdi, r15
+                ld(a, RSI, R13, -8);                                      // mov rsi, [r13-8]
+                b1(a, 0xBA); i32(a, in->op==OP_PRINTLN);                  // mov edx, imm32
+                BYTES(a, 0x48,0xB8); uint64_t fn = (uint64_t)(uintptr_t)&jit_print; put(a, &fn, 8);
+                BYTES(a, 0xFF,0xD0, 0x85,0xC0);                           // call rax; test eax,eax
+                jump(a, JNE, 2, FX_EXIT, i);
+                drop(a);
+            } break;
+            // Argumente an den Frameanfang (r14), dann Sprung; außerhalb der
+            // Region macht der Interpreter am Ziel weiter. Das Ziel kann mehr
+            // Stack brauchen (in->c ab fp): reicht er nicht, führt der
+            // Interpreter den TAILCALL aus (vergrößert oder meldet den Überlauf)
+            case OP_TAILCALL:
+                mem(a, 1, LEA, 1, RAX, R14, 8*in->c);
+                BYTES(a, 0x49,0x63,0x4F,0x20, 0x49,0x8D,0x0C,0xCC);          // movsxd rcx,[r15+32]; lea rcx,[r12+rcx*8]
+                BYTES(a, 0x48,0x39,0xC8);                                    // cmp rax, rcx
+                jump(a, JA, 2, FX_EXIT, i);
+                for(int32_t k=0; k<in->b; k++){ ld(a, RAX, R13, -8*(in->b - k)); st(a, RAX, R14, 8*k); }
+                mem(a, 1, LEA, 1, R13, R14, 8*in->b);                        // lea r13, [r14+8n]
+                jump_to(a, JMP, 1, (uint32_t)in->a, lo, hi);
+                break;
+            default: // CALL, RET, HALT: zurück in den Interpreter
+                jump(a, JMP, 1, FX_EXIT, i);
+                break;
+        }
+    }
+    jump(a, JMP, 1, FX_EXIT, hi + 1);
+
+    // Exit-Stubs und gemeinsamer Epilog
+    size_t* stub = (size_t*)malloc(A.nfix * sizeof(size_t) + 1);
+    if(!stub){ free(label); free(A.buf); free(A.fix); return NULL; }
+    for(size_t k=0;k<A.nfix;k++){
+        if(A.fix[k].kind != FX_EXIT) continue;
+        stub[k] = A.len;
+        b1(a, 0xB8); i32(a, (int32_t)A.fix[k].idx);                     // mov eax, idx
+        b1(a, 0xE9); i32(a, 0);                                           // jmp epilog (unten gepatcht)
+    }
+    size_t epi = A.len;
+    BYTES(a, 0x4C,0x89,0xE9, 0x4C,0x29,0xE1, 0x48,0xC1,0xE9,0x03);         // rcx = (r13-r12)/8
+    mem(a, 0, MOV_ST, 1, RCX, R15, 16);                                   // cx->sp = ecx
+    BYTES(a, 0x41,0x5F, 0x41,0x5E, 0x41,0x5D, 0x41,0x5C, 0x5B, 0xC3);      // pop ...; ret
+    for(size_t k=0;k<A.nfix;k++){
+        size_t tgt = (A.fix[k].kind == FX_LABEL) ? label[A.fix[k].idx - lo] : stub[k];
+        int32_t rel = (int32_t)((int64_t)tgt - (int64_t)(A.fix[k].pos + 4));
+        memcpy(A.buf + A.fix[k].pos, &rel, 4);
+        if(A.fix[k].kind == FX_EXIT){
+            int32_t r2 = (int32_t)((int64_t)epi - (int64_t)(stub[k] + 10));
+            memcpy(A.buf + stub[k] + 6, &r2, 4);
+        }
+    }
+    free(stub); free(label); free(A.fix);
+
+    // W^X: schreiben, dann auf ausführbar umschalten
+    size_t sz = (A.len + 4095) & ~(size_t)4095;
+    void* m = mmap(NULL, sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(m == MAP_FAILED){ free(A.buf); return NULL; }
+    memcpy(m, A.buf, A.len);
+    free(A.buf);
+    if(mprotect(m, sz, PROT_READ|PROT_EXEC) != 0){ munmap(m, sz); return NULL; }
+    if(j->nmaps == j->capmaps){
+        j->capmaps = j->capmaps ? j->capmaps*2 : 16;
+        j->maps = (void**)realloc(j->maps, j->capmaps * sizeof(void*));
+        j->map_sizes = (size_t*)realloc(j->map_sizes, j->capmaps * sizeof(size_t));
+        if(!j->maps || !j->map_sizes) abort();
+    }
+    j->maps[j->nmaps] = m; j->map_sizes[j->nmaps] = sz; j->nmaps++;
+    JitFn fn;
+    memcpy(&fn, &m, sizeof(fn));
+    return fn;
+}
+
+// Funktionsregion: ab Einsprung bis zum ersten RET (oder TAILCALL, dahinter
+// ist nach dem Peephole-Pass oft nichts mehr), hinter das kein Sprung der
+// Region mehr zeigt
+static int function_end(const Program* pr, uint32_t lo, uint32_t* hi){
+    uint32_t maxt = lo;
+    for(uint32_t i=lo; i<pr->ninsns && i-lo < JIT_MAX_REGION; i++){
+        const Insn* in = &pr->insns[i];
+        uint32_t t = 0;
+        if(in->op==OP_JMP || in->op==OP_JZ || in->op==OP_JNZ) t = (uint32_t)in->a;
+        else if(in->op==OP_LOAD_LOAD_LT_JZ || in->op==OP_LOCAL_LOCAL_LT_JZ ||
+                in->op==OP_LOAD_LEN_LT_JZ || in->op==OP_LOCAL_LEN_LT_JZ) t = (uint32_t)in->c;
+        if(t > maxt) maxt = t;
+        if((in->op==OP_RET || in->op==OP_TAILCALL) && maxt <= i){ *hi = i; return 1; }
+    }
+    return 0;
+}
+
+JitFn jit_hot(Jit* j, uint32_t idx, int is_call){
+    if(j->entry[idx]) return j->entry[idx];
+    if(j->failed[idx]) return NULL;
+    if(j->mode != JIT_ALWAYS && ++j->counters[idx] < JIT_THRESHOLD) return NULL;
+    uint32_t hi = 0;
+    if(is_call){
+        if(!function_end(j->pr, idx, &hi)){ j->failed[idx] = 1; return NULL; }
+    } else {
+        // Schleife: von idx bis zur weitesten Back-Edge auf idx
+        for(uint32_t i=idx; i<j->pr->ninsns && i-idx < JIT_MAX_REGION; i++)
+            if(j->pr->insns[i].op==OP_JMP && (uint32_t)j->pr->insns[i].a==idx) hi = i;
+        if(hi < idx){ j->failed[idx] = 1; return NULL; }
+    }
+    JitFn fn = compile_region(j, idx, hi);
+    if(!fn){ j->failed[idx] = 1; return NULL; }
+    j->entry[idx] = fn;
+    return fn;
+}
+
+Jit* jit_new(const Program* pr, int mode){
+    if(mode == JIT_OFF || pr->regs) return NULL;
+    Jit* j = (Jit*)calloc(1, sizeof(Jit));
+    if(!j) return NULL;
+    j->pr = pr; j->mode = mode;
+    j->popcnt = __builtin_cpu_supports("popcnt");
+    size_t n = (size_t)pr->ninsns + 1;
+    j->counters = (uint32_t*)calloc(n, sizeof(uint32_t));
+    j->entry    = (JitFn*)calloc(n, sizeof(JitFn));
+    j->failed   = (uint8_t*)calloc(n, 1);
+    if(!j->counters || !j->entry || !j->failed){ jit_free(j); return NULL; }
+    return j;
+}
+
+void jit_free(Jit* j){
+    if(!j) return;
+    for(size_t i=0;i<j->nmaps;i++) munmap(j->maps[i], j->map_sizes[i]);
+    free(j->maps); free(j->map_sizes);
+    free(j->counters); free(j->entry); free(j->failed);
+    free(j);
+}
+
+#else /* kein x86-64-Backend */
+
+int   jit_available(void){ return 0; }
+Jit*  jit_new(const Program* pr, int mode){ (void)pr; (void)mode; return NULL; }
+void  jit_free(Jit* j){ (void)j; }
+JitFn jit_hot(Jit* j, uint32_t idx, int is_call){ (void)j; (void)idx; (void)is_call; return NULL; }
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef NOVA_NOVAVM_H
+#define NOVA_NOVAVM_H
+// libnovavm - die Nova-VM als Bibliothek (der novavm-CLI ist nur ein Aufrufer).
+//
+// Kein globaler Zustand: ein NovaProgram ist nach dem Laden unveränderlich
+// (Code, Stringpool) und kann von beliebig vielen NovaVM-Instanzen
+// gleichzeitig benutzt werden, auch aus verschiedenen Threads. Jede Instanz
+// hat ihre eigenen Globals, Stacks, Arrays, Ausgabepuffer und JIT-Code; eine
+// Instanz selbst darf nur von einem Thread zur Zeit benutzt werden.
+//
+//   char err[256];
+//   NovaProgram* p = nova_program_load_file("prog.nvc", err, sizeof(err));
+//   NovaVM* vm = nova_vm_new(p);
+//   if(nova_vm_run(vm, 0) == NOVA_ERROR) fprintf(stderr, "%s\n", nova_vm_error(vm));
+//   nova_vm_free(vm); nova_program_free(p);
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Program NovaProgram;
+typedef struct NovaVM NovaVM;
+
+// Ergebnis von nova_vm_run
+enum { NOVA_DONE = 0, NOVA_ERROR = 1, NOVA_SUSPENDED = 2 };
+// JIT-Modus (nova_vm_set_jit)
+enum { NOVA_JIT_OFF = 0, NOVA_JIT_ON, NOVA_JIT_ALWAYS };
+
+// .nvc laden und prüfen (v1/v2, Stack- oder Register-Flavour). Bei Fehlern
+// NULL und die Meldung in err (darf NULL sein). load_mem kopiert die Daten.
+NovaProgram* nova_program_load_file(const char* path, char* err, size_t errlen);
+NovaProgram* nova_program_load_mem(const void* data, size_t len, char* err, size_t errlen);
+void         nova_program_free(NovaProgram* p);   // erst nach allen VMs darauf
+
+NovaVM* nova_vm_new(const NovaProgram* p);        // NULL bei OOM
+void    nova_vm_free(NovaVM* vm);
+
+// Ausgabe von print/println: fn(user, data, len) mit Blöcken bis bufsize
+// Bytes (0 = jeder Wert einzeln). fn == NULL: stdout (fd 1); bufsize 0
+// heißt dann stdio. Voreinstellung: stdout, 64 KiB. 0 = kein Speicher.
+typedef void (*NovaWriteFn)(void* user, const char* data, size_t len);
+int  nova_vm_set_output(NovaVM* vm, NovaWriteFn fn, void* user, size_t bufsize);
+// JIT-Modus; 0 = für dieses Programm/diese Plattform kein JIT (es wird
+// interpretiert)
+int  nova_vm_set_jit(NovaVM* vm, int mode);
+// Opcode-n-Gramme zählen (1..4, 0 = aus), Bericht über nova_vm_report;
+// 0 = für dieses Programm nicht möglich (Register-Bytecode) oder n ungültig
+int  nova_vm_set_ngrams(NovaVM* vm, int n);
+// Profiler (1 = an): Ausführungen je Opcode, Instruktion und Quellzeile,
+// Schleifen und Eigenzeit je Funktion; läuft ohne JIT und ohne n-Gramme,
+// Bericht über nova_vm_report. 0 = nicht möglich (Register-Bytecode)
+int  nova_vm_set_profile(NovaVM* vm, int on);
+
+// Programm ausführen. budget = maximale Anzahl Instruktionen für diesen
+// Aufruf (0 = unbegrenzt); ist es aufgebraucht, liefert run NOVA_SUSPENDED
+// und der nächste Aufruf macht an derselben Stelle weiter. Nach NOVA_DONE
+// oder NOVA_ERROR beginnt der nächste Aufruf einen neuen Lauf (Globals und
+// Arrays werden zurückgesetzt). Mit Budget laufen weder JIT noch n-Gramme,
+// Register-Bytecode kennt kein Budget (NOVA_ERROR). Mit Budget läuft auch
+// der Profiler nicht.
+int         nova_vm_run(NovaVM* vm, uint64_t budget);
+const char* nova_vm_error(const NovaVM* vm);      // Meldung nach NOVA_ERROR, mit pc und Zeile
+// n-Gramm- bzw. Profil-Bericht des letzten Laufs (nova_vm_set_ngrams,
+// nova_vm_set_profile)
+void        nova_vm_report(NovaVM* vm, FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef NOVA_NVC_H
+#define NOVA_NVC_H
+// Containerformat von .nvc-Dateien (gemeinsam für novac und novavm).
+//
+// v1 ("NOVABC01"/"NOVARC01"), sequentiell:
+//   [magic 8][u32 nstrs]{[u32 len][bytes]}*[u32 nregs (nur RC)][u32 code_len][code]
+//
+// v2 ("NOVABC02"/"NOVARC02"): fester Header mit Sektions-Offsets, damit die
+// VM die Datei per mmap einblenden und direkt aus dem Mapping lesen kann:
+//   [NvcHeader]
+//   [u32 stroff[nstrs+1]]       Offsets in den Blob, 4-Byte-ausgerichtet
+//   [String-Blob]               je String die Bytes + NUL
+//   [Code]                      NVC_CODE_ALIGN-ausgerichtet
+//   [Debug]                     optional (debug_len 0), 4-Byte-ausgerichtet
+// String i liegt bei blob+stroff[i] und hat die Länge stroff[i+1]-stroff[i]-1.
+// Alle Zahlen little-endian, Offsets relativ zum Dateianfang.
+//
+// Debug-Sektion (nur Stack-Bytecode, fehlt bei novac --strip; die VM liest
+// sie erst für Fehlermeldungen und Berichte):
+//   [u32 nfuncs][u32 names_len]
+//   {[u32 pc][u32 name]}*nfuncs      Funktionsanfang, name = Offset in die Namen
+//   [Namen]                          je Name die Bytes + NUL
+//   [Zeilenprogramm]                 bis zum Ende der Sektion
+//
+// Zeilenprogramm, wie DWARF .debug_line: Zustand pc = 0, line = 1; jeder
+// Befehl ändert beide und ergibt eine Zeile der Tabelle "Code ab pc gehört zu
+// line" (bis zur nächsten Zeile, pc aufsteigend):
+//   1..255   pc += (op-1) / NVC_LINE_RANGE,
+//            line += (op-1) % NVC_LINE_RANGE + NVC_LINE_BASE
+//   0        [uleb128 pc-Abstand][sleb128 Zeilen-Abstand]
+// Eine Zeile kostet so meist ein Byte.
+#include <stdint.h>
+
+#define NVC_HEADER_SIZE 56
+#define NVC_HEADER_MIN  48   // ohne debug_off/debug_len
+#define NVC_LINE_BASE   (-3)
+#define NVC_LINE_RANGE  8
+#define NVC_CODE_ALIGN  16
+
+typedef struct NvcHeader {
+    char     magic[8];     // "NOVABC02" / "NOVARC02"
+    uint32_t header_size;  // NVC_HEADER_SIZE (größere Header: neue Felder hinten)
+    uint32_t file_size;    // Gesamtlänge, gegen abgeschnittene Dateien
+    uint32_t nstrs;
+    uint32_t nregs;        // nur Register-Flavour, sonst 0
+    uint32_t stroff_off;   // Offset-Tabelle (nstrs+1 Einträge)
+    uint32_t blob_off;
+    uint32_t blob_len;
+    uint32_t code_off;
+    uint32_t code_len;
+    uint32_t reserved;     // 0
+    uint32_t debug_off;    // Debug-Sektion (0/0 = keine)
+    uint32_t debug_len;
+} NvcHeader;
+
+typedef char nvc_header_size_check[sizeof(NvcHeader) == NVC_HEADER_SIZE ? 1 : -1];
+
+#endif
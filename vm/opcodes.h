@@ -0,0 +1,180 @@
+#ifndef NOVA_OPCODES_H
+#define NOVA_OPCODES_H
+// Gemeinsamer Befehlssatz von novac und novavm.
+// Operanden sind little-endian i32 direkt hinter dem Opcode-Byte
+// (Ausnahme OP_PUSHI64: ein i64).
+
+enum {
+    OP_HALT=0, OP_PUSHI, OP_PUSHSTR,
+    OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_MOD,
+    OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE,
+    OP_AND, OP_OR, OP_NOT,
+    OP_JMP, OP_JZ,
+    OP_LOAD, OP_STORE,
+    OP_CALL, OP_RET,
+    OP_LOAD_LOCAL,        // k       : push stack[fp + k]  (früher OP_ARG; Parameter sind Locals 0..argc-1)
+    OP_PRINT, OP_PRINTLN,
+    // Superinstruktionen (von novac fusioniert)
+    OP_LOAD_LOAD_LT_JZ,   // a b off : if !(vars[a] < vars[b]) pc += off
+    OP_INC_SLOT,          // slot k  : vars[slot] += k
+    OP_LOAD_PUSHI_ADD,    // slot k  : push vars[slot] + k
+    // von der Konstantenfaltung in novac erzeugt
+    OP_NEG,               //         : x -> -x
+    OP_SHL,               // k       : x -> x << k  (0 <= k < 32, ersetzt x * 2^k)
+    // vom Peephole-Pass erzeugt
+    OP_TEE,               // slot    : vars[slot] = top (ohne pop; STORE s; LOAD s)
+    OP_JNZ,               // off     : if pop() != 0 pc += off
+    // Funktionsframes auf dem Wertestack: [fp] Parameter, danach Locals
+    OP_STORE_LOCAL,       // k       : stack[fp + k] = pop()
+    OP_ENTER,             // n       : n Locals (0-initialisiert) hinter den Parametern anlegen
+    // Superinstruktionen wie oben, auf Locals (stack[fp + k])
+    OP_LOCAL_LOCAL_LT_JZ, // a b off
+    OP_INC_LOCAL,         // k n
+    OP_LOAD_LOCAL_PUSHI_ADD, // k n
+    // Konstanten außerhalb von i32 (novac wählt PUSHI, wenn es passt)
+    OP_PUSHI64,           // k64     : push k
+    // überlaufgeprüft (novac --checked): Ergebnis außerhalb von 63 Bit bricht ab
+    OP_ADD_CHK, OP_SUB_CHK, OP_MUL_CHK,
+    // Bitoperationen auf dem Integer-Wert; Schiebeweite mod 64, >> arithmetisch
+    OP_BAND, OP_BOR, OP_BXOR, OP_LSH, OP_RSH,
+    OP_BNOT,              //         : x -> ~x
+    OP_POPCNT, OP_CTZ,    //         : Builtins popcount(x), ctz(x) (ctz(0) = 64)
+    OP_POP,               //         : Wert verwerfen (Aufruf als Anweisung)
+    // Integer-Arrays fester Länge (Heap-Objekt, vm/value.h)
+    OP_ALOAD,             //         : a i -> a[i]
+    OP_ASTORE,            //         : a i v -> (a[i] = v)
+    OP_ALOAD_NC, OP_ASTORE_NC, // wie oben ohne Prüfungen; novac hat 0 <= i < len(a) bewiesen
+    // Builtins array(n), len(a), sum(a) (a -> x) und fill(a,v), copy(a,b), add(a,b) (a x -> a)
+    OP_ANEW, OP_ALEN, OP_ASUM,
+    OP_AFILL, OP_ACOPY, OP_AADD,
+    // Superinstruktionen für Arrays in Variablen (Globals bzw. Locals)
+    OP_LOAD_LOAD_ALOAD,   // a i     : push vars[a][vars[i]]
+    OP_LOCAL_LOCAL_ALOAD, // a i
+    OP_LOAD_LOAD_ALOAD_NC, OP_LOCAL_LOCAL_ALOAD_NC, // ohne Prüfungen (wie ALOAD_NC)
+    OP_LOAD_LEN_LT_JZ,    // i a off : if !(vars[i] < len(vars[a])) pc += off
+    OP_LOCAL_LEN_LT_JZ,   // i a off
+    // return f(...): Argumente an den Anfang des aktuellen Frames, dann Sprung
+    OP_TAILCALL,          // absaddr argc (wie OP_CALL, ohne neuen Frame)
+    // --checked: wie OP_DIV, V_INT_MIN / -1 bricht mit "integer overflow" ab
+    OP_DIV_CHK,
+    OP_COUNT
+};
+
+// Operandenlänge in Bytes; -1 = unbekannter Opcode
+static inline int nova_op_operand_len(int op){
+    switch(op){
+        case OP_PUSHI: case OP_PUSHSTR:
+        case OP_JMP: case OP_JZ:
+        case OP_LOAD: case OP_STORE:
+        case OP_RET: case OP_LOAD_LOCAL:
+        case OP_SHL: case OP_TEE: case OP_JNZ:
+        case OP_STORE_LOCAL: case OP_ENTER:
+            return 4;
+        case OP_CALL: case OP_TAILCALL: case OP_INC_SLOT: case OP_LOAD_PUSHI_ADD:
+        case OP_INC_LOCAL: case OP_LOAD_LOCAL_PUSHI_ADD:
+        case OP_PUSHI64:
+        case OP_LOAD_LOAD_ALOAD: case OP_LOCAL_LOCAL_ALOAD:
+        case OP_LOAD_LOAD_ALOAD_NC: case OP_LOCAL_LOCAL_ALOAD_NC:
+            return 8;
+        case OP_LOAD_LOAD_LT_JZ: case OP_LOCAL_LOCAL_LT_JZ:
+        case OP_LOAD_LEN_LT_JZ: case OP_LOCAL_LEN_LT_JZ:
+            return 12;
+        case OP_HALT:
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_EQ: case OP_NE: case OP_LT: case OP_LE: case OP_GT: case OP_GE:
+        case OP_AND: case OP_OR: case OP_NOT:
+        case OP_PRINT: case OP_PRINTLN:
+        case OP_NEG:
+        case OP_ADD_CHK: case OP_SUB_CHK: case OP_MUL_CHK: case OP_DIV_CHK:
+        case OP_BAND: case OP_BOR: case OP_BXOR: case OP_LSH: case OP_RSH:
+        case OP_BNOT: case OP_POPCNT: case OP_CTZ:
+        case OP_POP: case OP_ALOAD: case OP_ASTORE: case OP_ALOAD_NC: case OP_ASTORE_NC:
+        case OP_ANEW: case OP_ALEN: case OP_ASUM: case OP_AFILL: case OP_ACOPY: case OP_AADD:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+static inline const char* nova_op_name(int op){
+    switch(op){
+        case OP_HALT: return "HALT";       case OP_PUSHI: return "PUSHI";
+        case OP_PUSHSTR: return "PUSHSTR"; case OP_ADD: return "ADD";
+        case OP_SUB: return "SUB";         case OP_MUL: return "MUL";
+        case OP_DIV: return "DIV";         case OP_MOD: return "MOD";
+        case OP_EQ: return "EQ";           case OP_NE: return "NE";
+        case OP_LT: return "LT";           case OP_LE: return "LE";
+        case OP_GT: return "GT";           case OP_GE: return "GE";
+        case OP_AND: return "AND";         case OP_OR: return "OR";
+        case OP_NOT: return "NOT";         case OP_JMP: return "JMP";
+        case OP_JZ: return "JZ";           case OP_LOAD: return "LOAD";
+        case OP_STORE: return "STORE";     case OP_CALL: return "CALL";
+        case OP_RET: return "RET";         case OP_LOAD_LOCAL: return "LOAD_LOCAL";
+        case OP_PRINT: return "PRINT";     case OP_PRINTLN: return "PRINTLN";
+        case OP_LOAD_LOAD_LT_JZ: return "LOAD_LOAD_LT_JZ";
+        case OP_INC_SLOT: return "INC_SLOT";
+        case OP_LOAD_PUSHI_ADD: return "LOAD_PUSHI_ADD";
+        case OP_NEG: return "NEG";         case OP_SHL: return "SHL";
+        case OP_TEE: return "TEE";         case OP_JNZ: return "JNZ";
+        case OP_STORE_LOCAL: return "STORE_LOCAL";
+        case OP_ENTER: return "ENTER";
+        case OP_LOCAL_LOCAL_LT_JZ: return "LOCAL_LOCAL_LT_JZ";
+        case OP_INC_LOCAL: return "INC_LOCAL";
+        case OP_LOAD_LOCAL_PUSHI_ADD: return "LOAD_LOCAL_PUSHI_ADD";
+        case OP_PUSHI64: return "PUSHI64";
+        case OP_ADD_CHK: return "ADD_CHK"; case OP_SUB_CHK: return "SUB_CHK";
+        case OP_MUL_CHK: return "MUL_CHK";
+        case OP_BAND: return "BAND";       case OP_BOR: return "BOR";
+        case OP_BXOR: return "BXOR";       case OP_LSH: return "LSH";
+        case OP_RSH: return "RSH";         case OP_BNOT: return "BNOT";
+        case OP_POPCNT: return "POPCNT";   case OP_CTZ: return "CTZ";
+        case OP_POP: return "POP";         case OP_ALOAD: return "ALOAD";
+        case OP_ASTORE: return "ASTORE";   case OP_ALOAD_NC: return "ALOAD_NC";
+        case OP_ASTORE_NC: return "ASTORE_NC";
+        case OP_ANEW: return "ANEW";       case OP_ALEN: return "ALEN";
+        case OP_ASUM: return "ASUM";       case OP_AFILL: return "AFILL";
+        case OP_ACOPY: return "ACOPY";     case OP_AADD: return "AADD";
+        case OP_LOAD_LOAD_ALOAD: return "LOAD_LOAD_ALOAD";
+        case OP_LOCAL_LOCAL_ALOAD: return "LOCAL_LOCAL_ALOAD";
+        case OP_LOAD_LOAD_ALOAD_NC: return "LOAD_LOAD_ALOAD_NC";
+        case OP_LOCAL_LOCAL_ALOAD_NC: return "LOCAL_LOCAL_ALOAD_NC";
+        case OP_LOAD_LEN_LT_JZ: return "LOAD_LEN_LT_JZ";
+        case OP_LOCAL_LEN_LT_JZ: return "LOCAL_LEN_LT_JZ";
+        case OP_TAILCALL: return "TAILCALL";
+        case OP_DIV_CHK: return "DIV_CHK";
+        default: return "?";
+    }
+}
+
+// ---- Register-Flavour (Magic "NOVARC01") ----
+// Drei-Adress-Code über einer Registerdatei: r[0..nslots) sind die
+// Variablenslots, danach folgen Temporaries und Konstanten (siehe
+// compiler/regalloc.c). Alle Operanden sind i32; Sprünge relativ zum
+// Instruktionsende. R_ADD..R_OR liegen in derselben Reihenfolge wie
+// OP_ADD..OP_OR.
+enum {
+    R_HALT=0, R_MOVI, R_MOVS, R_MOV,
+    R_ADD, R_SUB, R_MUL, R_DIV, R_MOD,
+    R_EQ, R_NE, R_LT, R_LE, R_GT, R_GE,
+    R_AND, R_OR, R_NOT,
+    R_JMP,                // off
+    R_JZ,                 // a off     : if r[a]==0 pc += off
+    R_JLT, R_JLE,         // a b off   : if r[a] <  / <= r[b] pc += off
+    R_JEQ, R_JNE,         // a b off   : if r[a] == / != r[b] pc += off
+    R_PRINT, R_PRINTLN,   // a
+    R_COUNT
+};
+
+// Anzahl i32-Operanden; -1 = unbekannter Opcode
+static inline int nova_rop_noperands(int op){
+    if(op >= R_ADD && op <= R_OR) return 3;
+    switch(op){
+        case R_HALT: return 0;
+        case R_JMP: case R_PRINT: case R_PRINTLN: return 1;
+        case R_MOVI: case R_MOVS: case R_MOV: case R_NOT: case R_JZ: return 2;
+        case R_JLT: case R_JLE: case R_JEQ: case R_JNE: return 3;
+        default: return -1;
+    }
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "out.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+// ohne Puffer (cap 0 mit fn) schreibt put() jeden Block direkt
+int out_init(Out* o, size_t cap, OutWriteFn fn, void* user){
+    out_free(o);
+    o->fn = fn; o->user = user;
+    o->stdio = (cap == 0 && !fn);
+    o->line  = fn ? 0 : isatty(1);
+    if(o->stdio) return 1;
+    if(cap == 0){ o->buf = NULL; o->cap = 0; return 1; }
+    o->buf = (char*)malloc(cap);
+    if(!o->buf){ o->stdio = !fn; return 0; }
+    o->cap = cap; o->len = 0;
+    return 1;
+}
+
+static void write_all(Out* o, const char* p, size_t n){
+    if(o->fn){ if(n) o->fn(o->user, p, n); return; }
+    while(n > 0){
+        ssize_t w = write(1, p, n);
+        if(w < 0){ if(errno == EINTR) continue; return; }  // EPIPE etc.: Ausgabe verwerfen
+        p += w; n -= (size_t)w;
+    }
+}
+
+void out_flush(Out* o){
+    if(o->stdio){ fflush(stdout); return; }
+    write_all(o, o->buf, o->len);
+    o->len = 0;
+}
+
+void out_free(Out* o){
+    if(!o->stdio) out_flush(o);
+    free(o->buf); o->buf = NULL; o->cap = o->len = 0;
+    o->stdio = 1; o->fn = NULL;
+}
+
+static void put(Out* o, const char* s, size_t n){
+    if(n > o->cap - o->len){
+        out_flush(o);
+        if(n >= o->cap){ write_all(o, s, n); return; }
+    }
+    memcpy(o->buf + o->len, s, n);
+    o->len += n;
+}
+
+static void put_int(Out* o, int64_t n){
+    if(o->stdio){ printf("%lld", (long long)n); return; }
+    char tmp[24], *p = tmp + sizeof(tmp);
+    uint64_t u = n < 0 ? 0u - (uint64_t)n : (uint64_t)n;
+    do { *--p = (char)('0' + u % 10); u /= 10; } while(u);
+    if(n < 0) *--p = '-';
+    put(o, p, (size_t)(tmp + sizeof(tmp) - p));
+}
+static void put_str(Out* o, const char* s, size_t n){
+    if(o->stdio) fwrite(s, 1, n, stdout);
+    else put(o, s, n);
+}
+
+int vm_print(Out* o, const Program* pr, Value v, int newline){
+    if(V_TAG(v) == V_TAG_STR){
+        uint64_t id = V_PAYLOAD(v);
+        if(id >= pr->nstrs) return 1;
+        if(o->stdio) fputs(pr->strs[id], stdout);
+        else put(o, pr->strs[id], pr->slens[id]);
+    } else if(V_IS_ARRAY(v)){
+        // [1, 2, 3]
+        const VArray* a = V_AS_ARRAY(v);
+        put_str(o, "[", 1);
+        for(int64_t i = 0; i < a->len; i++){
+            if(i) put_str(o, ", ", 2);
+            put_int(o, V_AS_INT(a->v[i]));
+        }
+        put_str(o, "]", 1);
+    } else if(!V_IS_INT(v) && V_TAG(v) != V_TAG_BOOL){
+        return 1;
+    } else {
+        put_int(o, V_IS_INT(v) ? V_AS_INT(v) : (int64_t)V_PAYLOAD(v));
+    }
+    if(newline){
+        if(o->stdio) fputc('\n', stdout);
+        else if(o->cap == 0) write_all(o, "\n", 1);
+        else {
+            if(o->len == o->cap) out_flush(o);
+            o->buf[o->len++] = '\n';
+            if(o->line) out_flush(o);
+        }
+    }
+    return 0;
+}
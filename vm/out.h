@@ -0,0 +1,38 @@
+#ifndef NOVA_OUT_H
+#define NOVA_OUT_H
+// Ausgabepfad von PRINT/PRINTLN (Interpreter, Register-VM, JIT).
+//
+// Statt printf/fputs/fputc je Wert sammelt die VM Ausgaben in einem eigenen
+// Puffer (Ganzzahlen per Hand nach dezimal) und schreibt ihn in großen
+// write(2)-Blöcken - oder übergibt ihn an eine Callback-Funktion (eingebettete
+// VM). Geleert wird, wenn der Puffer voll ist, am Ende jedes Laufs, vor
+// Laufzeitfehlern und - wenn stdout ein Terminal ist - nach jedem
+// Zeilenumbruch. out_init(o, 0, NULL, NULL) schaltet auf den alten stdio-Pfad.
+// Jede VM-Instanz hat ihr eigenes Out.
+#include <stddef.h>
+#include <stdint.h>
+#include "program.h"
+
+#define OUT_DEFAULT_BUFFER (64*1024)
+
+typedef void (*OutWriteFn)(void* user, const char* p, size_t n);
+
+typedef struct Out {
+    char*      buf;
+    size_t     cap, len;
+    int        stdio;     // 1 = printf/fputs (--out-buffer=0, nur ohne fn)
+    int        line;      // nach '\n' leeren (stdout ist ein Terminal)
+    OutWriteFn fn;        // NULL = write(2) auf fd 1
+    void*      user;
+} Out;
+
+// cap = Puffergröße (0 = stdio bzw. mit fn: ungepuffert); liefert 0 bei OOM
+// (Ausgabe geht dann über stdio bzw. ungepuffert an fn)
+int  out_init(Out* o, size_t cap, OutWriteFn fn, void* user);
+void out_flush(Out* o);
+void out_free(Out* o);
+// Wert ausgeben wie OP_PRINT/OP_PRINTLN (bool als 0/1); 1 = ungültige
+// String-Id bzw. kein druckbarer Wert (nichts ausgegeben)
+int  vm_print(Out* o, const Program* pr, Value v, int newline);
+
+#endif
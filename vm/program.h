@@ -0,0 +1,56 @@
+#ifndef NOVA_PROGRAM_H
+#define NOVA_PROGRAM_H
+// Geladenes Programm im internen Format (gemeinsam für Interpreter und JIT).
+#include <stddef.h>
+#include <stdint.h>
+#include "value.h"
+
+/* Wertestack (Operanden + Funktionsframes) und Aufrufstack liegen auf dem
+ * Heap und wachsen bei Bedarf durch Verdoppeln bis zur jeweiligen Grenze */
+#define VM_STACK_SLOTS 2048      /* Wertestack: Anfangsgröße in Einträgen   */
+#define VM_STACK_MAX   (1<<24)   /* Wertestack: Grenze ("stack overflow")   */
+#define VM_FRAMES_INIT 256       /* Aufrufstack: Anfangsgröße               */
+#define VM_MAX_FRAMES  (1<<20)   /* maximale Aufruftiefe                    */
+#define VM_MAX_LOCALS  256       /* Parameter + Locals je Frame             */
+#define VM_MAX_GLOBALS (1<<24) /* globale Variablen-Slots                */
+
+/* Vordekodierte Instruktion: feste Breite, natürlich ausgerichtet.
+ * Operanden sind beim Laden bereits dekodiert, Sprungziele absolut
+ * (Index in Program.insns), h zeigt direkt auf den Handler. */
+typedef struct Insn {
+    const void* h;    /* Handler-Adresse (nur computed-goto-Dispatch) */
+    int32_t op;       /* Opcode (switch-Dispatch, Diagnose)           */
+    int32_t a;        /* 1. Operand bzw. Sprungziel                   */
+    int32_t b;        /* 2. Operand (OP_CALL/OP_TAILCALL: argc)       */
+    int32_t c;        /* 3. Operand (Superinstruktionen; CALL/TAILCALL:
+                         Stackbedarf des Ziels ab fp, verify_stack)   */
+} Insn;
+
+/* OP_PUSHI64: Konstante in a (untere) und b (obere 32 Bit) */
+#define INSN_I64(in) ((int64_t)(((uint64_t)(uint32_t)(in)->b << 32) | (uint32_t)(in)->a))
+
+/* Einheitliche Program-Struktur für die VM; nach dem Laden unveränderlich
+ * und von mehreren VM-Instanzen (Threads) gleichzeitig nutzbar */
+typedef struct Program {
+    uint32_t nstrs;   /* Anzahl Strings im Konstantenpool */
+    const char **strs;/* String-Tabelle (zeigt ins Image bzw. strblob) */
+    uint32_t *slens;  /* Stringlängen (für den Ausgabepuffer) */
+    char    *strblob; /* v1: NUL-terminierte Kopie aller Strings */
+    const uint8_t *code; /* Bytecode im Image (Byte-Offsets für Berichte) */
+    uint32_t code_len;/* Länge des Bytecodes               */
+    const uint8_t *debug; /* Debug-Sektion im Image, ungeprüft (nvc.h) */
+    uint32_t debug_len;   /* 0 = keine                      */
+    Insn    *insns;   /* übersetzter Code + OP_HALT-Sentinel */
+    uint32_t ninsns;  /* Anzahl Instruktionen ohne Sentinel */
+    int      regs;    /* 1 = Register-Flavour ("NOVARC01") */
+    uint32_t nregs;   /* Größe der Registerdatei (nur regs) */
+    uint32_t nvars;   /* höchster benutzter Slot + 1 (Globals je VM) */
+    uint32_t stack_need; /* Wertestack-Bedarf des Hauptprogramms      */
+    void    *image;   /* .nvc-Datei: mmap (image_mapped) oder malloc */
+    size_t   image_len;
+    int      image_mapped;
+    char    *err;     /* nur beim Laden: Puffer für die Fehlermeldung */
+    size_t   errlen;
+} Program;
+
+#endif
@@ -0,0 +1,133 @@
+#include "value.h"
+#include "opcodes.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Zahlwert von Integer und bool; 0 bei anderen Typen
+static int as_num(Value v, int64_t* out){
+    if(V_IS_INT(v)){ *out = V_AS_INT(v); return 1; }
+    if(V_TAG(v) == V_TAG_BOOL){ *out = (int64_t)V_PAYLOAD(v); return 1; }
+    return 0;
+}
+
+const char* value_binop(int op, Value a, Value b, Value* r){
+    int64_t x, y;
+    int num = as_num(a, &x) && as_num(b, &y);
+    switch(op){
+        case OP_EQ: *r = V_BOOL(num ? x == y : a == b); return NULL;
+        case OP_NE: *r = V_BOOL(num ? x != y : a != b); return NULL;
+        case OP_AND: *r = V_BOOL(V_TRUTHY(a) && V_TRUTHY(b)); return NULL;
+        case OP_OR:  *r = V_BOOL(V_TRUTHY(a) || V_TRUTHY(b)); return NULL;
+        default: break;
+    }
+    if(!num) return (op >= OP_EQ && op <= OP_GE) ? "type error: comparison needs numbers" : "type error: arithmetic needs numbers";
+    Value xa = V_INT(x), yb = V_INT(y);
+    switch(op){
+        case OP_ADD_CHK: return v_add_ov(xa, yb, r) ? "integer overflow" : NULL;
+        case OP_SUB_CHK: return v_sub_ov(xa, yb, r) ? "integer overflow" : NULL;
+        case OP_MUL_CHK: return v_mul_ov(xa, yb, r) ? "integer overflow" : NULL;
+        case OP_DIV_CHK:
+            if(y == 0) return "division by zero";
+            return v_div_ov(xa, yb, r) ? "integer overflow" : NULL;
+        case OP_BAND: *r = xa & yb; return NULL;
+        case OP_BOR:  *r = xa | yb; return NULL;
+        case OP_BXOR: *r = xa ^ yb; return NULL;
+        case OP_LSH:  *r = V_SHL(xa, yb); return NULL;
+        case OP_RSH:  *r = V_SHR(xa, yb); return NULL;
+        case OP_ADD: *r = V_ADD(xa, yb); return NULL;
+        case OP_SUB: *r = V_SUB(xa, yb); return NULL;
+        case OP_MUL: *r = V_MUL(xa, yb); return NULL;
+        case OP_DIV: if(y == 0) return "division by zero"; *r = V_INT(V_AS_INT(xa) / V_AS_INT(yb)); return NULL;
+        case OP_MOD: if(y == 0) return "mod by zero";      *r = V_INT(V_AS_INT(xa) % V_AS_INT(yb)); return NULL;
+        case OP_LT: *r = V_BOOL(xa <  yb); return NULL;
+        case OP_LE: *r = V_BOOL(xa <= yb); return NULL;
+        case OP_GT: *r = V_BOOL(xa >  yb); return NULL;
+        case OP_GE: *r = V_BOOL(xa >= yb); return NULL;
+        default: return "bad operator";
+    }
+}
+
+const char* value_unop(int op, Value a, Value* r){
+    int64_t x;
+    if(!as_num(a, &x)) return "type error: bit operation needs a number";
+    switch(op){
+        case OP_BNOT:   *r = V_INT(~x); return NULL;
+        case OP_POPCNT: *r = V_INT(v_popcount(x)); return NULL;
+        case OP_CTZ:    *r = V_INT(v_ctz(x)); return NULL;
+        default: return "bad operator";
+    }
+}
+
+// Index (Integer oder bool) prüfen; 0 = gültig
+static const char* index_of(Value a, Value i, int64_t* k){
+    if(!V_IS_ARRAY(a)) return "type error: indexing a non-array";
+    if(!as_num(i, k)) return "type error: array index needs a number";
+    if((uint64_t)*k >= (uint64_t)V_AS_ARRAY(a)->len) return "array index out of range";
+    return NULL;
+}
+
+const char* value_aload(Value a, Value i, Value* r){
+    int64_t k; const char* e = index_of(a, i, &k);
+    if(e) return e;
+    *r = V_AS_ARRAY(a)->v[k];
+    return NULL;
+}
+
+const char* value_astore(Value a, Value i, Value v){
+    int64_t k, x; const char* e = index_of(a, i, &k);
+    if(e) return e;
+    if(!as_num(v, &x)) return "type error: arrays hold numbers";
+    V_AS_ARRAY(a)->v[k] = V_INT(x);
+    return NULL;
+}
+
+// Die Schleifen arbeiten direkt auf den Integer-Wörtern (Summe der Wörter =
+// Wort der Summe) und lassen sich vom C-Compiler vektorisieren.
+static Value arr_sum(const Value* v, int64_t n){
+    uint64_t s = 0;
+    for(int64_t i = 0; i < n; i++) s += (uint64_t)v[i];
+    return (Value)s;
+}
+static void arr_fill(Value* v, int64_t n, Value x){
+    for(int64_t i = 0; i < n; i++) v[i] = x;
+}
+static void arr_add(Value* d, const Value* s, int64_t n){
+    for(int64_t i = 0; i < n; i++) d[i] = V_ADD(d[i], s[i]);
+}
+
+const char* value_builtin(VHeap* h, int op, Value a, Value b, Value* r){
+    int64_t x;
+    if(op == OP_ANEW){
+        if(!as_num(a, &x)) return "type error: array size needs a number";
+        if(x < 0 || x > V_ARRAY_MAX) return "array size out of range";
+        VArray* arr = (VArray*)calloc(1, sizeof(VArray) + (size_t)x * sizeof(Value));
+        if(!arr) return "out of memory";
+        arr->len = x; arr->next = h->arrays; h->arrays = arr;
+        *r = V_ARRAY(arr);
+        return NULL;
+    }
+    if(!V_IS_ARRAY(a)) return "type error: array builtin needs an array";
+    VArray* d = V_AS_ARRAY(a);
+    switch(op){
+        case OP_ALEN: *r = V_INT(d->len); return NULL;
+        case OP_ASUM: *r = arr_sum(d->v, d->len); return NULL;
+        case OP_AFILL:
+            if(!as_num(b, &x)) return "type error: arrays hold numbers";
+            arr_fill(d->v, d->len, V_INT(x));
+            *r = a; return NULL;
+        case OP_ACOPY: case OP_AADD: {
+            if(!V_IS_ARRAY(b)) return "type error: array builtin needs an array";
+            VArray* s = V_AS_ARRAY(b);
+            if(s->len != d->len) return "array length mismatch";
+            if(op == OP_ACOPY) memmove(d->v, s->v, (size_t)d->len * sizeof(Value));
+            else arr_add(d->v, s->v, d->len);
+            *r = a; return NULL;
+        }
+        default: return "bad operator";
+    }
+}
+
+void value_heap_free(VHeap* h){
+    while(h->arrays){ VArray* n = h->arrays->next; free(h->arrays); h->arrays = n; }
+}
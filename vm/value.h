@@ -0,0 +1,138 @@
+#ifndef NOVA_VALUE_H
+#define NOVA_VALUE_H
+// Werte der VM: ein 64-Bit-Wort mit Tag in den unteren Bits.
+//
+//   ...xxxxxxx0  Integer, 63 Bit; Wert = Wort >> 1
+//   ...xxxxx001  bool, Payload 0/1 (false = 1, true = 9)
+//   ...xxxxx011  String, Payload = Id im Konstantenpool
+//   ...xxxxx101  Heap-Objekt: Zeiger | 5 (bislang nur VArray)
+//
+// Integer brauchen damit kein Auspacken: Addition, Subtraktion und
+// Vergleiche arbeiten direkt auf den Wörtern, ein gemeinsamer Test
+// ((a|b)&1) entscheidet über den schnellen Pfad. Integer 0 ist das Wort 0,
+// calloc/memset liefern also gültige Werte. Falsch sind genau die Wörter
+// 0 (Integer 0) und 1 (false).
+#include <stdint.h>
+
+typedef int64_t Value;
+
+// Integer-Array fester Länge; v[] enthält Integer-Wörter (nie andere Tags),
+// calloc liefert also ein mit 0 gefülltes Array. Alle Arrays hängen in der
+// Liste ihres Heaps (je VM-Instanz) und leben bis value_heap_free().
+typedef struct VArray {
+    struct VArray* next;
+    int64_t len;
+    Value v[];
+} VArray;
+#define V_ARRAY_MAX     ((int64_t)1 << 28)
+
+typedef struct VHeap { VArray* arrays; } VHeap;
+
+enum { V_TAG_BOOL = 1, V_TAG_STR = 3, V_TAG_OBJ = 5 };
+
+#define V_INT_MAX       ((int64_t)(((uint64_t)1 << 62) - 1))
+#define V_INT_MIN       (-V_INT_MAX - 1)
+#define V_INT(i)        ((Value)((uint64_t)(int64_t)(i) << 1))
+#define V_AS_INT(v)     ((int64_t)(v) >> 1)
+#define V_IS_INT(v)     (((v) & 1) == 0)
+#define V_BOTH_INT(a,b) ((((a) | (b)) & 1) == 0)
+#define V_TAG(v)        ((int)((v) & 7))
+#define V_PAYLOAD(v)    ((uint64_t)(v) >> 3)
+#define V_FALSE         ((Value)V_TAG_BOOL)
+#define V_TRUE          ((Value)(8 | V_TAG_BOOL))
+#define V_BOOL(c)       ((c) ? V_TRUE : V_FALSE)
+#define V_STR(id)       ((Value)(((uint64_t)(id) << 3) | V_TAG_STR))
+#define V_TRUTHY(v)     ((uint64_t)(v) > 1)
+#define V_IS_ARRAY(v)   (V_TAG(v) == V_TAG_OBJ)
+#define V_ARRAY(p)      ((Value)((uintptr_t)(p) | V_TAG_OBJ))
+#define V_AS_ARRAY(v)   ((VArray*)(uintptr_t)((v) & ~(Value)7))
+
+// Wrap-around-Arithmetik auf Integer-Wörtern (modulo 2^63, ohne UB)
+#define V_ADD(a,b)      ((Value)((uint64_t)(a) + (uint64_t)(b)))
+#define V_SUB(a,b)      ((Value)((uint64_t)(a) - (uint64_t)(b)))
+#define V_MUL(a,b)      ((Value)((uint64_t)V_AS_INT(a) * (uint64_t)(b)))
+// Division (b != 0): passen beide Wörter in 32 Bit, d.h. die Werte in 31,
+// reicht die deutlich schnellere 32-Bit-Division und kann nicht überlaufen
+#define V_FITS32(a,b)   ((int32_t)(a) == (a) && (int32_t)(b) == (b))
+#define V_DIV(a,b)      (V_FITS32(a,b) ? V_INT((int32_t)(a) / (int32_t)(b)) : V_INT(V_AS_INT(a) / V_AS_INT(b)))
+#define V_MOD(a,b)      (V_FITS32(a,b) ? (Value)((int32_t)(a) % (int32_t)(b)) : V_INT(V_AS_INT(a) % V_AS_INT(b)))
+
+// Bitoperationen: &, |, ^ gehen direkt auf den Wörtern (Tag-Bit 0 bleibt 0)
+#define V_BNOT(a)       ((a) ^ ~(Value)1)
+#define V_SHL(a,b)      ((Value)((uint64_t)(a) << (V_AS_INT(b) & 63)))
+#define V_SHR(a,b)      (((a) >> (V_AS_INT(b) & 63)) & ~(Value)1)
+
+#if defined(__GNUC__)
+#define V_LIKELY(x)     __builtin_expect(!!(x), 1)
+#else
+#define V_LIKELY(x)     (x)
+#endif
+
+// Geprüfte Arithmetik auf Integer-Wörtern: 1 = Ergebnis passt nicht in
+// 63 Bit. Die Wörter sind die Werte mal 2, ein int64-Überlauf des Worts ist
+// also genau ein Überlauf des Werts.
+static inline int v_add_ov(Value a, Value b, Value* r){
+#if defined(__GNUC__)
+    return __builtin_add_overflow(a, b, r);
+#else
+    *r = V_ADD(a,b); return ((a ^ *r) & (b ^ *r)) < 0;
+#endif
+}
+static inline int v_sub_ov(Value a, Value b, Value* r){
+#if defined(__GNUC__)
+    return __builtin_sub_overflow(a, b, r);
+#else
+    *r = V_SUB(a,b); return ((a ^ b) & (a ^ *r)) < 0;
+#endif
+}
+static inline int v_mul_ov(Value a, Value b, Value* r){
+#if defined(__GNUC__)
+    return __builtin_mul_overflow(V_AS_INT(a), b, r);
+#else
+    int64_t x = V_AS_INT(a);
+    *r = V_MUL(a,b);
+    return x != 0 && ((x == -1 && b == INT64_MIN) || *r / x != b);
+#endif
+}
+
+// Division: 1 auch bei Divisor 0 (value_binop meldet dann "division by zero")
+static inline int v_div_ov(Value a, Value b, Value* r){
+    if(b == 0 || (a == V_INT(V_INT_MIN) && b == V_INT(-1))) return 1;
+    *r = V_DIV(a,b); return 0;
+}
+
+static inline int64_t v_popcount(int64_t x){
+#if defined(__GNUC__)
+    return __builtin_popcountll((unsigned long long)x);
+#else
+    uint64_t u = (uint64_t)x; int n = 0;
+    while(u){ u &= u - 1; n++; }
+    return n;
+#endif
+}
+static inline int64_t v_ctz(int64_t x){
+    if(x == 0) return 64;
+#if defined(__GNUC__)
+    return __builtin_ctzll((unsigned long long)x);
+#else
+    uint64_t u = (uint64_t)x; int n = 0;
+    while(!(u & 1)){ u >>= 1; n++; }
+    return n;
+#endif
+}
+
+// Langsamer Pfad für OP_ADD..OP_OR, OP_*_CHK und die Bitoperationen, wenn nicht beide Operanden
+// Integer sind (oder bei Division durch 0, Überlauf): bool zählt als 0/1,
+// Strings sind nur mit EQ/NE vergleichbar. Liefert NULL oder die Fehlermeldung.
+const char* value_binop(int op, Value a, Value b, Value* r);
+// dasselbe für OP_BNOT, OP_POPCNT, OP_CTZ
+const char* value_unop(int op, Value a, Value* r);
+// Arrays: langsamer Pfad von ALOAD/ASTORE (Typ- und Bereichsfehler) und
+// die Builtins OP_ANEW..OP_AADD (b nur bei den zweistelligen; neue Arrays
+// kommen in den Heap h)
+const char* value_aload(Value a, Value i, Value* r);
+const char* value_astore(Value a, Value i, Value v);
+const char* value_builtin(VHeap* h, int op, Value a, Value b, Value* r);
+void value_heap_free(VHeap* h);
+
+#endif
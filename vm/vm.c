@@ -0,0 +1,1218 @@
+
+// vm/vm.c - libnovavm: Laden, Prüfen und Ausführen von .nvc-Programmen
+// (API in novavm.h). Aller veränderliche Zustand hängt an der NovaVM-Instanz.
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "novavm.h"
+#include "nvc.h"
+#include "opcodes.h"
+#include "program.h"
+#include "jit.h"
+#include "out.h"
+
+static int translate_program(Program* pr);
+static int translate_regs(Program* pr);
+
+/* Ladefehler in den Puffer des Aufrufers (nova_program_load_*); liefert 0 */
+static int load_err(Program* pr, const char* fmt, ...){
+    if(pr->err && pr->errlen){
+        va_list ap; va_start(ap, fmt);
+        vsnprintf(pr->err, pr->errlen, fmt, ap);
+        va_end(ap);
+    }
+    return 0;
+}
+
+static int32_t read_i32(const uint8_t* p){ return (int32_t)( (uint32_t)p[0] | ((uint32_t)p[1]<<8) | ((uint32_t)p[2]<<16) | ((uint32_t)p[3]<<24) ); }
+
+/* Datei als Image einblenden: mmap (read-only), sonst komplett einlesen
+ * (Pipes, Dateisysteme ohne mmap) */
+static int map_image(Program* pr, const char* path){
+    int fd = open(path, O_RDONLY);
+    if(fd < 0){ load_err(pr, "%s: %s", path, strerror(errno)); return 0; }
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+        void* m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(m != MAP_FAILED){
+            close(fd);
+            pr->image = m; pr->image_len = (size_t)st.st_size; pr->image_mapped = 1;
+            return 1;
+        }
+    }
+    size_t cap = 1 << 16, len = 0;
+    uint8_t* buf = (uint8_t*)malloc(cap);
+    for(;;){
+        if(!buf){ load_err(pr, "oom"); close(fd); return 0; }
+        ssize_t r = read(fd, buf + len, cap - len);
+        if(r < 0){ if(errno == EINTR) continue; load_err(pr, "%s: %s", path, strerror(errno)); free(buf); close(fd); return 0; }
+        if(r == 0) break;
+        len += (size_t)r;
+        if(len == cap){ uint8_t* nb = (uint8_t*)realloc(buf, cap *= 2); if(!nb) free(buf); buf = nb; }
+    }
+    close(fd);
+    pr->image = buf; pr->image_len = len; pr->image_mapped = 0;
+    return 1;
+}
+
+/* v1: sequentiell; Strings werden in einen gemeinsamen Blob kopiert, weil
+ * sie in der Datei nicht NUL-terminiert sind */
+static int parse_v1(Program* pr){
+    const uint8_t* p = (const uint8_t*)pr->image + 8;
+    const uint8_t* end = (const uint8_t*)pr->image + pr->image_len;
+    #define NEED(n, what) do { if((size_t)(end - p) < (size_t)(n)){ load_err(pr, "read error (%s)", what); return 0; } } while(0)
+    NEED(4, "nstrs");
+    pr->nstrs = (uint32_t)read_i32(p); p += 4;
+    /* Strings zweimal durchlaufen: Größe, dann kopieren */
+    const uint8_t* q = p; size_t total = 0;
+    for(uint32_t i = 0; i < pr->nstrs; i++){
+        if((size_t)(end - q) < 4){ load_err(pr, "read error (str len)"); return 0; }
+        uint32_t len = (uint32_t)read_i32(q); q += 4;
+        if((size_t)(end - q) < len){ load_err(pr, "read error (str data)"); return 0; }
+        q += len; total += (size_t)len + 1;
+    }
+    if(pr->nstrs){
+        pr->strs = (const char**)malloc(pr->nstrs * sizeof(char*));
+        pr->slens = (uint32_t*)malloc(pr->nstrs * sizeof(uint32_t));
+        pr->strblob = (char*)malloc(total);
+        if(!pr->strs || !pr->slens || !pr->strblob){ load_err(pr, "oom"); return 0; }
+    }
+    char* d = pr->strblob;
+    for(uint32_t i = 0; i < pr->nstrs; i++){
+        uint32_t len = (uint32_t)read_i32(p); p += 4;
+        memcpy(d, p, len); d[len] = 0; p += len;
+        pr->strs[i] = d;
+        pr->slens[i] = (uint32_t)strlen(d);  /* bis zum ersten NUL, wie fputs */
+        d += (size_t)len + 1;
+    }
+    if(pr->regs){ NEED(4, "nregs"); pr->nregs = (uint32_t)read_i32(p); p += 4; }
+    NEED(4, "code_len");
+    pr->code_len = (uint32_t)read_i32(p); p += 4;
+    NEED(pr->code_len, "code data");
+    pr->code = p;
+    #undef NEED
+    return 1;
+}
+
+/* v2: Sektionen prüfen, Strings und Code direkt aus dem Image */
+static int parse_v2(Program* pr){
+    NvcHeader h;
+    if(pr->image_len < NVC_HEADER_MIN){ load_err(pr, "read error (header)"); return 0; }
+    memcpy(&h, pr->image, NVC_HEADER_MIN);
+    /* ältere Header enden vor debug_off */
+    if(h.header_size >= NVC_HEADER_SIZE && pr->image_len >= NVC_HEADER_SIZE) memcpy(&h, pr->image, sizeof(h));
+    else h.debug_off = h.debug_len = 0;
+    uint64_t size = pr->image_len;
+    if(h.header_size < NVC_HEADER_MIN || h.file_size != size
+       || h.stroff_off < h.header_size || (h.stroff_off & 3)
+       || (uint64_t)h.stroff_off + 4 * ((uint64_t)h.nstrs + 1) > h.blob_off
+       || (uint64_t)h.blob_off + h.blob_len > h.code_off
+       || (h.code_off & (NVC_CODE_ALIGN - 1))
+       || (uint64_t)h.code_off + h.code_len > size
+       || (h.debug_len && ((h.debug_off & 3) || h.debug_off < (uint64_t)h.code_off + h.code_len
+                           || (uint64_t)h.debug_off + h.debug_len > size))){
+        load_err(pr, "bad header (v2 .nvc)");
+        return 0;
+    }
+    const uint8_t* base = (const uint8_t*)pr->image;
+    const uint32_t* off = (const uint32_t*)(base + h.stroff_off);
+    const char* blob = (const char*)(base + h.blob_off);
+    pr->nstrs = h.nstrs;
+    if(pr->nstrs){
+        pr->strs = (const char**)malloc(pr->nstrs * sizeof(char*));
+        pr->slens = (uint32_t*)malloc(pr->nstrs * sizeof(uint32_t));
+        if(!pr->strs || !pr->slens){ load_err(pr, "oom"); return 0; }
+    }
+    for(uint32_t i = 0; i < pr->nstrs; i++){
+        uint32_t s = off[i], e = off[i+1];
+        if(s >= e || e > h.blob_len || blob[e-1] != 0){ load_err(pr, "bad string table (v2 .nvc)"); return 0; }
+        pr->strs[i] = blob + s;
+        pr->slens[i] = e - s - 1;
+    }
+    pr->nregs = h.nregs;
+    pr->code = base + h.code_off;
+    pr->code_len = h.code_len;
+    pr->debug = h.debug_len ? base + h.debug_off : NULL;
+    pr->debug_len = h.debug_len;
+    return 1;
+}
+
+/* ---- Debug-Sektion (nvc.h) ----
+ * Wird beim Laden nur gegen die Dateigrenzen geprüft und erst dekodiert,
+ * wenn eine Meldung oder ein Bericht Zeilen braucht (debug_open); das
+ * Program selbst bleibt dabei unverändert. */
+typedef struct { uint32_t pc; int32_t line; } LineRow;
+
+typedef struct {
+    LineRow* rows; uint32_t nrows;  /* Zeilentabelle, aufsteigend nach pc */
+    uint32_t nfuncs;
+    const uint8_t* funcs;   /* je 8 Byte: pc, Namens-Offset */
+    const char* names; uint32_t names_len;
+} DebugInfo;
+
+static int read_leb(const uint8_t** p, const uint8_t* end, int sign, int64_t* out){
+    uint64_t v = 0; int shift = 0; uint8_t c;
+    do {
+        if(*p == end || shift > 63) return 0;
+        c = *(*p)++;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        shift += 7;
+    } while(c & 0x80);
+    if(sign && shift < 64 && (c & 0x40)) v |= ~(uint64_t)0 << shift;
+    *out = (int64_t)v;
+    return 1;
+}
+
+static void debug_close(DebugInfo* di){
+    free(di->rows);
+    memset(di, 0, sizeof(*di));
+}
+
+/* Sektion lesen und das Zeilenprogramm dekodieren; 0 = keine, beschädigt
+ * oder kein Speicher (di ist dann leer) */
+static int debug_open(const Program* pr, DebugInfo* di){
+    memset(di, 0, sizeof(*di));
+    if(!pr->debug || pr->debug_len < 8) return 0;
+    const uint8_t* p = pr->debug;
+    const uint8_t* end = p + pr->debug_len;
+    uint64_t nf = (uint32_t)read_i32(p), nlen = (uint32_t)read_i32(p + 4);
+    uint64_t fixed = 8 + 8 * nf + nlen;
+    if(fixed > pr->debug_len) return 0;
+    di->nfuncs = (uint32_t)nf;
+    di->funcs = p + 8;
+    di->names = (const char*)(di->funcs + 8 * nf);
+    di->names_len = (uint32_t)nlen;
+    /* jede Zeile braucht mindestens ein Byte */
+    const uint8_t* q = p + fixed;
+    di->rows = (LineRow*)malloc(((size_t)(end - q) + 1) * sizeof(LineRow));
+    if(!di->rows){ debug_close(di); return 0; }
+    int64_t pc = 0, line = 1;
+    while(q < end){
+        uint8_t op = *q++;
+        int64_t dpc, dl;
+        if(op){ dpc = (op - 1) / NVC_LINE_RANGE; dl = (op - 1) % NVC_LINE_RANGE + NVC_LINE_BASE; }
+        else if(!read_leb(&q, end, 0, &dpc) || !read_leb(&q, end, 1, &dl)){ debug_close(di); return 0; }
+        pc += dpc; line += dl;
+        if(dpc < 0 || pc > UINT32_MAX || line < 0 || line > INT32_MAX){ debug_close(di); return 0; }
+        di->rows[di->nrows].pc = (uint32_t)pc;
+        di->rows[di->nrows].line = (int32_t)line;
+        di->nrows++;
+    }
+    return 1;
+}
+
+/* Quellzeile zum Byte-Offset pc; 0 = unbekannt */
+static int debug_line(const DebugInfo* di, uint32_t pc){
+    uint32_t lo = 0, hi = di->nrows;   /* erste Zeile mit Offset > pc */
+    while(lo < hi){
+        uint32_t mid = lo + (hi - lo) / 2;
+        if(di->rows[mid].pc <= pc) lo = mid + 1; else hi = mid;
+    }
+    return lo ? di->rows[lo - 1].line : 0;
+}
+
+/* Name der Funktion, die bei pc beginnt; NULL = unbekannt */
+static const char* debug_func(const DebugInfo* di, uint32_t pc){
+    for(uint32_t i = 0; i < di->nfuncs; i++){
+        if((uint32_t)read_i32(di->funcs + 8 * (size_t)i) != pc) continue;
+        uint32_t off = (uint32_t)read_i32(di->funcs + 8 * (size_t)i + 4);
+        if(off < di->names_len && memchr(di->names + off, 0, di->names_len - off)) return di->names + off;
+        return NULL;
+    }
+    return NULL;
+}
+
+/* Länge der Instruktion bei code[pc] (Stack- bzw. Register-Flavour) */
+static uint32_t insn_len(const Program* pr, uint32_t pc){
+    return pr->regs ? 1 + 4u * (uint32_t)nova_rop_noperands(pr->code[pc])
+                    : 1 + (uint32_t)nova_op_operand_len(pr->code[pc]);
+}
+
+/* Byte-Offset der Instruktion idx */
+static uint32_t insn_pc(const Program* pr, uint32_t idx){
+    uint32_t pc = 0;
+    for(uint32_t i = 0; i < idx && i < pr->ninsns; i++) pc += insn_len(pr, pc);
+    return pc;
+}
+
+/* Byte-Offset jeder Instruktion (Bytecode im Image, vgl. translate_program) */
+static uint32_t* insn_offsets(const Program* pr){
+    uint32_t* pcs = (uint32_t*)malloc(((size_t)pr->ninsns + 1) * sizeof(uint32_t));
+    if(!pcs) return NULL;
+    uint32_t pc = 0;
+    for(uint32_t i = 0; i < pr->ninsns; i++){
+        pcs[i] = pc;
+        pc += insn_len(pr, pc);
+    }
+    pcs[pr->ninsns] = pc;
+    return pcs;
+}
+
+/* Position für Meldungen: " at pc=N (line L)", ohne Zeilentabelle nur pc */
+static void debug_where(const Program* pr, uint32_t pc, char* buf, size_t n){
+    DebugInfo di;
+    int line = debug_open(pr, &di) ? debug_line(&di, pc) : 0;
+    debug_close(&di);
+    if(line > 0) snprintf(buf, n, " at pc=%u (line %d)", pc, line);
+    else snprintf(buf, n, " at pc=%u", pc);
+}
+
+/* Ladefehler an Byte-Offset pc */
+static int load_err_pc(Program* pr, uint32_t pc, const char* fmt, ...){
+    if(pr->err && pr->errlen){
+        va_list ap; va_start(ap, fmt);
+        vsnprintf(pr->err, pr->errlen, fmt, ap);
+        va_end(ap);
+        size_t len = strlen(pr->err);
+        debug_where(pr, pc, pr->err + len, pr->errlen - len);
+    }
+    return 0;
+}
+
+/* Image (pr->image) prüfen und übersetzen; gibt pr bei Fehlern frei */
+static Program* load_image(Program* pr) {
+    char magic[9] = {0};
+    memcpy(magic, pr->image, pr->image_len < 8 ? pr->image_len : 8);
+    if (pr->image_len < 8 || (memcmp(magic, "NOVABC0", 7) != 0 && memcmp(magic, "NOVARC0", 7) != 0)
+        || (magic[7] != '1' && magic[7] != '2')) {
+        load_err(pr, "bad magic: '%s'", magic);
+        nova_program_free(pr); return NULL;
+    }
+    pr->regs = (magic[4] == 'R');
+    if (!(magic[7] == '2' ? parse_v2(pr) : parse_v1(pr))) { nova_program_free(pr); return NULL; }
+
+    /* einmalig in das interne Instruktionsformat übersetzen */
+    if (!(pr->regs ? translate_regs(pr) : translate_program(pr))) { nova_program_free(pr); return NULL; }
+    pr->err = NULL; pr->errlen = 0;
+    return pr;
+}
+
+NovaProgram* nova_program_load_file(const char* path, char* err, size_t errlen) {
+    Program* pr = (Program*)calloc(1, sizeof(Program));
+    if (!pr) { if (err && errlen) snprintf(err, errlen, "oom"); return NULL; }
+    pr->err = err; pr->errlen = errlen;
+    if (!map_image(pr, path)) { free(pr); return NULL; }
+    return load_image(pr);
+}
+
+NovaProgram* nova_program_load_mem(const void* data, size_t len, char* err, size_t errlen) {
+    Program* pr = (Program*)calloc(1, sizeof(Program));
+    void* copy = malloc(len ? len : 1);
+    if (!pr || !copy) { free(pr); free(copy); if (err && errlen) snprintf(err, errlen, "oom"); return NULL; }
+    memcpy(copy, data, len);
+    pr->err = err; pr->errlen = errlen;
+    pr->image = copy; pr->image_len = len; pr->image_mapped = 0;
+    return load_image(pr);
+}
+
+void nova_program_free(Program* pr) {
+    if (!pr) return;
+    free(pr->strs);
+    free(pr->slens);
+    free(pr->strblob);
+    free(pr->insns);
+    if (pr->image_mapped) munmap(pr->image, pr->image_len);
+    else free(pr->image);
+    free(pr);
+}
+
+/* Dispatch: mit GCC/Clang per "computed goto" (jeder Handler springt selbst
+ * zum nächsten, eigener indirekter Sprung je Handler), sonst portabler switch.
+ * Abschaltbar zur Build-Zeit über -DNOVA_DISPATCH_SWITCH. */
+#if defined(__GNUC__) && !defined(NOVA_DISPATCH_SWITCH)
+#define NOVA_THREADED 1
+#endif
+
+typedef struct Prof Prof;
+typedef struct Profile Profile;
+static int interp(NovaVM* vm, const void* const** handlers, void* aux);
+static int interp_reg(NovaVM* vm, const void* const** handlers);
+
+/* Sprungziel (Byte-Offset) -> Instruktionsindex per binärer Suche über die
+ * Instruktionsanfänge start[0..count] (start[count] = code_len); -1, wenn off
+ * keine Instruktionsgrenze ist. Ersetzt eine Tabelle über alle Bytes, die bei
+ * großen Dateien den Start dominiert hat. */
+static int32_t insn_index(const uint32_t* start, uint32_t count, int64_t off){
+    if(off < 0 || off > (int64_t)start[count]) return -1;
+    uint32_t lo = 0, hi = count;
+    while(lo < hi){
+        uint32_t mid = lo + (hi - lo) / 2;
+        if((int64_t)start[mid] < off) lo = mid + 1; else hi = mid;
+    }
+    return (int64_t)start[lo] == off ? (int32_t)lo : -1;
+}
+
+/* Stackwirkung je Opcode für verify_stack: pop Einträge lesen/entfernen,
+ * push ablegen; operandenabhängig (CALL, TAILCALL, RET, ENTER) dort */
+enum { SE_POP1 = 1, SE_POP2 = 2, SE_POP3 = 3, SE_PUSH = 4,  /* Bits 0-1: pop, Bit 2: push */
+       SE_LOCAL_A = 8, SE_LOCAL_STORE = 16, SE_LOCAL_AB = 32, /* Local-Operanden */
+       SE_FLOW = 64, SE_OPND = 128 };                          /* Sprung, Aufruf, Ende; Wirkung aus Operanden */
+static const uint8_t stack_fx[256] = {
+    [OP_PUSHI]=SE_PUSH, [OP_PUSHSTR]=SE_PUSH, [OP_PUSHI64]=SE_PUSH, [OP_LOAD]=SE_PUSH,
+    [OP_LOAD_LOCAL]=SE_PUSH|SE_LOCAL_A, [OP_LOAD_PUSHI_ADD]=SE_PUSH,
+    [OP_LOAD_LOCAL_PUSHI_ADD]=SE_PUSH|SE_LOCAL_A,
+    [OP_LOAD_LOAD_ALOAD]=SE_PUSH, [OP_LOAD_LOAD_ALOAD_NC]=SE_PUSH,
+    [OP_LOCAL_LOCAL_ALOAD]=SE_PUSH|SE_LOCAL_AB, [OP_LOCAL_LOCAL_ALOAD_NC]=SE_PUSH|SE_LOCAL_AB,
+    [OP_ADD]=SE_POP2|SE_PUSH, [OP_SUB]=SE_POP2|SE_PUSH, [OP_MUL]=SE_POP2|SE_PUSH,
+    [OP_DIV]=SE_POP2|SE_PUSH, [OP_MOD]=SE_POP2|SE_PUSH,
+    [OP_EQ]=SE_POP2|SE_PUSH, [OP_NE]=SE_POP2|SE_PUSH, [OP_LT]=SE_POP2|SE_PUSH,
+    [OP_LE]=SE_POP2|SE_PUSH, [OP_GT]=SE_POP2|SE_PUSH, [OP_GE]=SE_POP2|SE_PUSH,
+    [OP_AND]=SE_POP2|SE_PUSH, [OP_OR]=SE_POP2|SE_PUSH,
+    [OP_ADD_CHK]=SE_POP2|SE_PUSH, [OP_SUB_CHK]=SE_POP2|SE_PUSH, [OP_MUL_CHK]=SE_POP2|SE_PUSH,
+    [OP_DIV_CHK]=SE_POP2|SE_PUSH,
+    [OP_BAND]=SE_POP2|SE_PUSH, [OP_BOR]=SE_POP2|SE_PUSH, [OP_BXOR]=SE_POP2|SE_PUSH,
+    [OP_LSH]=SE_POP2|SE_PUSH, [OP_RSH]=SE_POP2|SE_PUSH,
+    [OP_ALOAD]=SE_POP2|SE_PUSH, [OP_ALOAD_NC]=SE_POP2|SE_PUSH,
+    [OP_AFILL]=SE_POP2|SE_PUSH, [OP_ACOPY]=SE_POP2|SE_PUSH, [OP_AADD]=SE_POP2|SE_PUSH,
+    [OP_NOT]=SE_POP1|SE_PUSH, [OP_NEG]=SE_POP1|SE_PUSH, [OP_SHL]=SE_POP1|SE_PUSH,
+    [OP_BNOT]=SE_POP1|SE_PUSH, [OP_POPCNT]=SE_POP1|SE_PUSH, [OP_CTZ]=SE_POP1|SE_PUSH,
+    [OP_TEE]=SE_POP1|SE_PUSH, [OP_ANEW]=SE_POP1|SE_PUSH, [OP_ALEN]=SE_POP1|SE_PUSH,
+    [OP_ASUM]=SE_POP1|SE_PUSH,
+    [OP_STORE]=SE_POP1, [OP_STORE_LOCAL]=SE_POP1|SE_LOCAL_STORE,
+    [OP_PRINT]=SE_POP1, [OP_PRINTLN]=SE_POP1, [OP_POP]=SE_POP1,
+    [OP_ASTORE]=SE_POP3, [OP_ASTORE_NC]=SE_POP3,
+    [OP_INC_LOCAL]=SE_LOCAL_A,
+    [OP_JZ]=SE_POP1|SE_FLOW, [OP_JNZ]=SE_POP1|SE_FLOW, [OP_JMP]=SE_FLOW,
+    [OP_LOAD_LOAD_LT_JZ]=SE_FLOW, [OP_LOAD_LEN_LT_JZ]=SE_FLOW,
+    [OP_LOCAL_LOCAL_LT_JZ]=SE_FLOW|SE_LOCAL_AB, [OP_LOCAL_LEN_LT_JZ]=SE_FLOW|SE_LOCAL_AB,
+    [OP_HALT]=SE_FLOW, [OP_RET]=SE_FLOW|SE_OPND, [OP_CALL]=SE_FLOW|SE_OPND,
+    [OP_TAILCALL]=SE_FLOW|SE_OPND, [OP_ENTER]=SE_OPND,
+};
+
+/* Abstrakte Stacktiefe über den Kontrollfluss: jede erreichbare Instruktion
+ * hat eine feste Tiefe (relativ zu fp) und gehört zu genau einer Funktion
+ * (Einsprung = CALL-/TAILCALL-Ziel mit Tiefe argc) bzw. zum Hauptprogramm
+ * (ab 0, Tiefe 0). Abgelehnt werden Unterlauf, verschiedene Tiefen an
+ * Zusammenführungen, Locals oberhalb der Tiefe und ein vom Hauptprogramm
+ * erreichbares RET. Nicht erreichbarer Code bleibt ungeprüft (wird nie
+ * ausgeführt). Nebenbei fällt die größte Tiefe je Funktion ab: CALL und
+ * TAILCALL tragen den Bedarf ihres Ziels in c, pr->stack_need den des
+ * Hauptprogramms. Wer ihn vor dem Sprung reserviert, braucht in der
+ * Dispatch-Schleife (und im JIT) keine Prüfung bei PUSH. */
+typedef struct { int32_t depth, owner; } StackState;  /* depth + 1, 0 = nicht erreicht */
+
+#define IS_TARGET(bits, i) ((bits)[(i) >> 3] & (1u << ((i) & 7)))
+
+/* Zustand wird nur an Sprung-/Call-Zielen (Bitmap tgt, von translate_program)
+ * gespeichert: alle anderen Instruktionen erreicht nur ihr Vorgänger */
+static int verify_stack(Program* pr, Insn* ins, uint32_t count, const uint32_t* start, const uint8_t* tgt){
+    StackState* st = (StackState*)calloc((size_t)count + 1, sizeof(StackState));
+    uint32_t* work = (uint32_t*)malloc(((size_t)count + 1) * sizeof(uint32_t));
+    int32_t* need  = (int32_t*)calloc((size_t)count + 1, sizeof(int32_t)); /* je Einsprung, [count] = Hauptprogramm */
+    uint32_t* calls = NULL; size_t ncalls = 0, capcalls = 0;  /* erreichbare CALL/TAILCALL */
+    int ok = st && work && need;
+    if(!ok) load_err(pr, "oom");
+    uint32_t nwork = 0;
+    /* Kante nach Ziel t mit Tiefe d im Kontext own (-1 = Hauptprogramm) */
+    #define EDGE(t, d, own) do { uint32_t t_ = (uint32_t)(t); \
+        if(t_ == count) break; \
+        if(st[t_].depth == 0){ st[t_].depth = (d) + 1; st[t_].owner = (own); work[nwork++] = t_; } \
+        else if(st[t_].owner != (own)){ load_err_pc(pr, start[i], "jump into another function"); ok = 0; } \
+        else if(st[t_].depth != (d) + 1){ load_err_pc(pr, start[i], "inconsistent stack depth"); ok = 0; } } while(0)
+    if(ok && count){ st[0].depth = 1; st[0].owner = -1; work[nwork++] = 0; }
+    while(ok && nwork){
+        /* ab einem Ziel geradeaus bis zum nächsten Ziel oder Kontrolltransfer */
+        uint32_t i = work[--nwork];
+        int32_t own = st[i].owner, d = st[i].depth - 1;
+        int32_t* nw = &need[own < 0 ? count : (uint32_t)own];
+        if(d > *nw) *nw = d;
+        for(;;){
+            const Insn* in = &ins[i];
+            unsigned fx = stack_fx[in->op & 0xff];
+            int32_t pop = (int32_t)(fx & 3), push = (fx & SE_PUSH) != 0;
+            if(fx & SE_OPND){
+                if(in->op == OP_CALL || in->op == OP_TAILCALL){ pop = in->b; push = in->op == OP_CALL; }
+                else if(in->op == OP_RET) pop = in->a != 0;
+                else push = in->a;   /* ENTER */
+            }
+            if(d < pop){ load_err_pc(pr, start[i], "stack underflow"); ok = 0; break; }
+            int32_t nd = d - pop + push;
+            if(nd > VM_STACK_MAX){ load_err_pc(pr, start[i], "stack too deep"); ok = 0; break; }
+            if(nd > *nw) *nw = nd;
+            /* Locals liegen im Frame unterhalb der aktuellen Tiefe */
+            if(fx & (SE_LOCAL_A | SE_LOCAL_STORE | SE_LOCAL_AB)){
+                int32_t hi = fx & SE_LOCAL_AB && in->b > in->a ? in->b : in->a;
+                if(hi >= d - ((fx & SE_LOCAL_STORE) != 0)){ load_err_pc(pr, start[i], "bad local %d", hi); ok = 0; break; }
+            }
+            if(fx & SE_FLOW){
+                int falls = 1;
+                switch(in->op){
+                    case OP_HALT: falls = 0; break;
+                    case OP_RET:
+                        if(own < 0){ load_err_pc(pr, start[i], "return outside function"); ok = 0; }
+                        else if(in->a != 0 && in->a != 1){ load_err_pc(pr, start[i], "bad return"); ok = 0; }
+                        falls = 0; break;
+                    case OP_JMP: EDGE(in->a, nd, own); falls = 0; break;
+                    case OP_JZ: case OP_JNZ: EDGE(in->a, nd, own); break;
+                    case OP_CALL: case OP_TAILCALL:
+                        EDGE(in->a, in->b, in->a);
+                        if(ncalls == capcalls){
+                            capcalls = capcalls ? 2 * capcalls : 64;
+                            uint32_t* nc = (uint32_t*)realloc(calls, capcalls * sizeof(uint32_t));
+                            if(!nc){ load_err(pr, "oom"); ok = 0; break; }
+                            calls = nc;
+                        }
+                        calls[ncalls++] = i;
+                        falls = in->op == OP_CALL; break;
+                    default: EDGE(in->c, nd, own); break;   /* *_LT_JZ */
+                }
+                if(!ok || !falls) break;
+            }
+            d = nd;
+            if(++i == count) break;
+            if(IS_TARGET(tgt, i)){ EDGE(i, d, own); break; }
+        }
+    }
+    #undef EDGE
+    if(ok){
+        for(size_t k = 0; k < ncalls; k++) ins[calls[k]].c = need[ins[calls[k]].a];
+        pr->stack_need = (uint32_t)need[count];
+    }
+    free(st); free(work); free(need); free(calls);
+    return ok;
+}
+
+static int32_t mark_target(uint8_t* bits, int32_t t){
+    if(t >= 0) bits[t >> 3] |= (uint8_t)(1u << (t & 7));
+    return t;
+}
+
+/* Übersetzt den Bytecode einmal in pr->insns: bekannte Opcodes, vollständige
+ * Operanden, Sprung-/Call-Ziele auf Instruktionsgrenzen, Slots und
+ * String-Ids im Bereich. Hinter der letzten Instruktion liegt ein
+ * OP_HALT-Sentinel, daher darf ein Sprung auch genau auf code_len zeigen.
+ * Die Dispatch-Schleife braucht danach weder pc<n-Check noch Dekodierung;
+ * verify_stack prüft zusätzlich die Stacktiefen. */
+static int translate_program(Program* pr){
+    const uint8_t* code = pr->code;
+    uint32_t n = pr->code_len;
+    /* Instruktionsanfänge (nur count+1 Einträge werden tatsächlich berührt) */
+    uint32_t* start = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if(!start){ load_err(pr, "oom"); return 0; }
+    uint32_t count = 0;
+    for(uint32_t pc=0; pc<n; ){
+        int len = nova_op_operand_len(code[pc]);
+        if(len < 0){ load_err_pc(pr, pc, "unknown opcode %u", code[pc]); free(start); return 0; }
+        if((uint64_t)pc + 1 + (uint32_t)len > n){ load_err_pc(pr, pc, "truncated operand"); free(start); return 0; }
+        start[count++] = pc;
+        pc += 1 + (uint32_t)len;
+    }
+    start[count] = n;
+    /* Sprung-/Call-Ziele zusätzlich als Bitmap für verify_stack */
+    uint8_t* tgt = (uint8_t*)calloc((size_t)count / 8 + 1, 1);
+    if(!tgt){ load_err(pr, "oom"); free(start); return 0; }
+    #define IDX(t) mark_target(tgt, insn_index(start, count, (t)))
+
+    Insn* out = (Insn*)calloc((size_t)count + 1, sizeof(Insn));
+    if(!out){ load_err(pr, "oom"); free(start); free(tgt); return 0; }
+#ifdef NOVA_THREADED
+    const void* const* handlers = NULL;
+    interp(NULL, &handlers, NULL);
+#endif
+    int ok = 1;
+    int32_t nvars = 1;    /* höchster benutzter globaler Slot + 1 */
+    Insn* ins = out;
+    for(uint32_t pc=0; pc<n && ok; ins++){
+        uint8_t op = code[pc];
+        uint32_t next = pc + 1 + (uint32_t)nova_op_operand_len(op);
+        ins->op = op;
+        switch(op){
+            case OP_JMP: case OP_JZ: case OP_JNZ: {
+                int32_t t = IDX((int64_t)next + read_i32(&code[pc+1]));
+                if(t < 0){ load_err_pc(pr, pc, "bad jump target"); ok = 0; break; }
+                ins->a = t;
+            } break;
+            case OP_CALL: case OP_TAILCALL: {
+                int32_t t = IDX((uint32_t)read_i32(&code[pc+1]));
+                int32_t argc = read_i32(&code[pc+5]);
+                if(t < 0 || argc < 0 || argc > VM_MAX_LOCALS){ load_err_pc(pr, pc, "bad call"); ok = 0; break; }
+                ins->a = t; ins->b = argc;
+            } break;
+            case OP_LOAD: case OP_STORE: case OP_TEE:
+            case OP_INC_SLOT: case OP_LOAD_PUSHI_ADD: {
+                int32_t slot = read_i32(&code[pc+1]);
+                if(slot < 0 || slot >= VM_MAX_GLOBALS){ load_err_pc(pr, pc, "bad slot %d", slot); ok = 0; break; }
+                if(slot >= nvars) nvars = slot + 1;
+                ins->a = slot;
+                if(op == OP_INC_SLOT || op == OP_LOAD_PUSHI_ADD) ins->b = read_i32(&code[pc+5]);
+            } break;
+            case OP_LOAD_LOAD_LT_JZ: case OP_LOAD_LEN_LT_JZ:
+            case OP_LOAD_LOAD_ALOAD: case OP_LOAD_LOAD_ALOAD_NC: {
+                int32_t sa = read_i32(&code[pc+1]), sb = read_i32(&code[pc+5]);
+                int jz = op == OP_LOAD_LOAD_LT_JZ || op == OP_LOAD_LEN_LT_JZ;
+                int32_t t = jz ? IDX((int64_t)next + read_i32(&code[pc+9])) : 0;
+                if(sa < 0 || sa >= VM_MAX_GLOBALS || sb < 0 || sb >= VM_MAX_GLOBALS){ load_err_pc(pr, pc, "bad slot"); ok = 0; break; }
+                if(sa >= nvars) nvars = sa + 1;
+                if(sb >= nvars) nvars = sb + 1;
+                if(t < 0){ load_err_pc(pr, pc, "bad jump target"); ok = 0; break; }
+                ins->a = sa; ins->b = sb; ins->c = t;
+            } break;
+            case OP_PUSHSTR: {
+                int32_t id = read_i32(&code[pc+1]);
+                if(id < 0 || (uint32_t)id >= pr->nstrs){ load_err_pc(pr, pc, "bad string id %d", id); ok = 0; break; }
+                ins->a = id;
+            } break;
+            case OP_PUSHI: case OP_RET:
+                ins->a = read_i32(&code[pc+1]);
+                break;
+            case OP_PUSHI64: {
+                ins->a = read_i32(&code[pc+1]); ins->b = read_i32(&code[pc+5]);
+                int64_t k = INSN_I64(ins);
+                if(k < V_INT_MIN || k > V_INT_MAX){ load_err_pc(pr, pc, "constant out of range"); ok = 0; }
+            } break;
+            case OP_LOAD_LOCAL: case OP_STORE_LOCAL: case OP_ENTER:
+            case OP_INC_LOCAL: case OP_LOAD_LOCAL_PUSHI_ADD:
+                ins->a = read_i32(&code[pc+1]);
+                if(ins->a < 0 || ins->a >= VM_MAX_LOCALS + (op==OP_ENTER)){ load_err_pc(pr, pc, "bad local %d", ins->a); ok = 0; }
+                if(op == OP_INC_LOCAL || op == OP_LOAD_LOCAL_PUSHI_ADD) ins->b = read_i32(&code[pc+5]);
+                break;
+            case OP_LOCAL_LOCAL_LT_JZ: case OP_LOCAL_LEN_LT_JZ:
+            case OP_LOCAL_LOCAL_ALOAD: case OP_LOCAL_LOCAL_ALOAD_NC: {
+                int32_t ka = read_i32(&code[pc+1]), kb = read_i32(&code[pc+5]);
+                int jz = op == OP_LOCAL_LOCAL_LT_JZ || op == OP_LOCAL_LEN_LT_JZ;
+                int32_t t = jz ? IDX((int64_t)next + read_i32(&code[pc+9])) : 0;
+                if(ka < 0 || ka >= VM_MAX_LOCALS || kb < 0 || kb >= VM_MAX_LOCALS){ load_err_pc(pr, pc, "bad local"); ok = 0; break; }
+                if(t < 0){ load_err_pc(pr, pc, "bad jump target"); ok = 0; break; }
+                ins->a = ka; ins->b = kb; ins->c = t;
+            } break;
+            case OP_SHL:
+                ins->a = read_i32(&code[pc+1]);
+                if(ins->a < 0 || ins->a > 31){ load_err_pc(pr, pc, "bad shift %d", ins->a); ok = 0; }
+                break;
+            default: break;
+        }
+#ifdef NOVA_THREADED
+        ins->h = handlers[op];
+#endif
+        pc = next;
+    }
+    #undef IDX
+    if(ok) ok = verify_stack(pr, out, count, start, tgt);
+    free(start); free(tgt);
+    if(!ok){ free(out); return 0; }
+    pr->nvars = (uint32_t)nvars;
+    out[count].op = OP_HALT;
+#ifdef NOVA_THREADED
+    out[count].h = handlers[OP_HALT];
+#endif
+    pr->insns = out;
+    pr->ninsns = count;
+    return 1;
+}
+
+/* ---- Profiling (--ngrams) ----
+ * Zählt dynamische Opcode-n-Gramme über sequentiell ausgeführte
+ * Instruktionen; ein genommener Sprung beginnt ein neues Fenster, da
+ * Superinstruktionen keine Sprungziele überdecken können. Läuft in einer
+ * eigens kompilierten Variante der Dispatch-Schleife (interp_prof), der
+ * normale Pfad bleibt ohne Hook. */
+typedef struct { uint32_t key; uint64_t count; } NgramEnt;
+
+struct Prof {
+    int         ngram;    /* n (1..4) */
+    const Insn* prev;     /* zuletzt ausgeführte Instruktion */
+    uint32_t    window;   /* letzte Opcodes, je 8 Bit */
+    int         filled;
+    NgramEnt*   tab; size_t cap, count;
+    uint64_t    lost;     /* ohne Speicher nicht gezählt */
+};
+
+static void prof_count(Prof* pf, uint32_t key){
+    if(pf->count*2 >= pf->cap){
+        size_t ncap = pf->cap ? pf->cap*2 : 256;
+        NgramEnt* nt = (NgramEnt*)calloc(ncap, sizeof(NgramEnt));
+        if(!nt){ pf->lost++; return; }
+        for(size_t i=0;i<pf->cap;i++){
+            if(!pf->tab[i].count) continue;
+            size_t h = (pf->tab[i].key * 2654435761u) & (ncap-1);
+            while(nt[h].count) h = (h+1) & (ncap-1);
+            nt[h] = pf->tab[i];
+        }
+        free(pf->tab); pf->tab = nt; pf->cap = ncap;
+    }
+    size_t h = (key * 2654435761u) & (pf->cap-1);
+    while(pf->tab[h].count && pf->tab[h].key != key) h = (h+1) & (pf->cap-1);
+    if(!pf->tab[h].count){ pf->tab[h].key = key; pf->count++; }
+    pf->tab[h].count++;
+}
+
+static inline void prof_hook(Prof* pf, const Insn* in){
+    if(pf->prev + 1 != in) pf->filled = 0;
+    pf->prev = in;
+    uint32_t mask = (pf->ngram >= 4) ? 0xFFFFFFFFu : ((1u << (8*pf->ngram)) - 1);
+    pf->window = ((pf->window << 8) | (uint8_t)in->op) & mask;
+    if(++pf->filled >= pf->ngram) prof_count(pf, pf->window);
+}
+
+static int ngram_cmp(const void* x, const void* y){
+    const NgramEnt* a = (const NgramEnt*)x; const NgramEnt* b = (const NgramEnt*)y;
+    return (a->count < b->count) - (a->count > b->count);
+}
+
+static void prof_reset(Prof* pf){
+    free(pf->tab);
+    memset(pf, 0, sizeof(*pf));
+}
+
+static void prof_report(Prof* pf, FILE* out){
+    uint64_t total = 0; size_t k = 0;
+    for(size_t i=0;i<pf->cap;i++) if(pf->tab[i].count){ total += pf->tab[i].count; pf->tab[k++] = pf->tab[i]; }
+    qsort(pf->tab, k, sizeof(NgramEnt), ngram_cmp);
+    fprintf(out, "-- top opcode %d-grams (%llu total) --\n", pf->ngram, (unsigned long long)total);
+    if(pf->lost) fprintf(out, "(%llu not counted: out of memory)\n", (unsigned long long)pf->lost);
+    for(size_t i=0;i<k && i<20;i++){
+        fprintf(out, "%12llu %5.1f%%  ", (unsigned long long)pf->tab[i].count, 100.0*(double)pf->tab[i].count/(double)total);
+        for(int j=pf->ngram-1;j>=0;j--)
+            fprintf(out, "%s%s", nova_op_name((pf->tab[i].key >> (8*j)) & 0xFF), j ? " " : "\n");
+    }
+    free(pf->tab); pf->tab = NULL; pf->cap = pf->count = 0; pf->lost = 0;
+}
+
+/* ---- Profiling (--profile) ----
+ * Zählt jede ausgeführte Instruktion (hits je Index; die Opcode-Summen
+ * ergeben sich daraus) und misst die Eigenzeit je Funktion: bei CALL,
+ * TAILCALL und RET geht die seit dem letzten Wechsel vergangene Zeit an die
+ * Funktion oben auf dem Profil-Stack, Rekursion zählt also nicht doppelt.
+ * Läuft in interp_profile; Zeilen und Funktionsnamen liest erst der Bericht
+ * aus der Debug-Sektion. */
+struct Profile {
+    uint64_t* hits;       /* je Instruktion */
+    uint64_t* calls;      /* je Funktionsanfang (Instruktionsindex) */
+    uint64_t* ticks;      /* Eigenzeit je Funktionsanfang, Index 0 = Hauptprogramm */
+    int32_t*  fn;         /* Funktionsanfänge der aktiven Frames, fn[0] = 0 */
+    int32_t   fsp, fcap;
+    int32_t   lost;       /* Frames ohne Platz im Profil-Stack (oom) */
+    uint64_t  t_last, t_total;   /* in Ticks (prof_now) */
+    uint64_t  wall0, wall_ns;    /* Laufzeit in ns, rechnet Ticks um */
+};
+
+/* ---- VM-Instanz ---- */
+// Eintrag des Aufrufstacks
+typedef struct VmFrame { const Insn* ret; int32_t fp; } VmFrame;
+
+enum { VM_FRESH, VM_SUSPENDED };
+
+struct NovaVM {
+    const Program* pr;      /* geteilt, nur gelesen */
+    Value*   vars;          /* Globals (pr->nvars) */
+    VHeap    heap;          /* Arrays dieser Instanz */
+    Out      out;
+    int      jit_mode, ngram, profiling;
+    Prof     prof;
+    Profile  profile;       /* --profile; Daten des letzten Laufs */
+    const char* error;      /* nach NOVA_ERROR */
+    uint32_t err_insn;      /* Instruktion des Laufzeitfehlers, UINT32_MAX = keine */
+    char     errbuf[256];   /* error mit Position (nova_vm_run) */
+    /* Ausführungszustand; bleibt bei NOVA_SUSPENDED für den nächsten Lauf */
+    int      state;
+    Value*   stack;   int32_t sp, scap;
+    VmFrame* frames;  int32_t fsp, fcap;
+    int32_t  fp;
+    uint32_t ip;            /* Index der nächsten Instruktion */
+};
+
+// Stack auf mindestens need Einträge (je size Bytes) verdoppeln; 0 = Grenze
+// max erreicht oder kein Speicher
+static int vm_grow(void** p, int32_t* cap, int64_t need, int32_t max, size_t size){
+    if(need > max) return 0;
+    int32_t nc = *cap;
+    while(nc < need) nc = nc > max/2 ? max : nc*2;
+    void* q = realloc(*p, (size_t)nc * size);
+    if(!q) return 0;
+    *p = q; *cap = nc;
+    return 1;
+}
+
+/* --profile: Zähler und Zeitmessung (struct Profile oben). Ticks sind auf
+ * x86-64 der TSC (ein paar ns je Funktionswechsel statt eines
+ * clock_gettime), sonst ns; der Bericht rechnet über die Laufzeit um. */
+static uint64_t wall_now(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+#if defined(__x86_64__) && defined(__GNUC__)
+static inline uint64_t prof_now(void){ return __builtin_ia32_rdtsc(); }
+#else
+static inline uint64_t prof_now(void){ return wall_now(); }
+#endif
+
+static void profile_free(Profile* pf){
+    free(pf->hits); free(pf->calls); free(pf->ticks); free(pf->fn);
+    memset(pf, 0, sizeof(*pf));
+}
+
+static int profile_reset(Profile* pf, uint32_t ninsns){
+    profile_free(pf);
+    size_t n = (size_t)ninsns + 1;
+    pf->hits  = (uint64_t*)calloc(n, sizeof(uint64_t));
+    pf->calls = (uint64_t*)calloc(n, sizeof(uint64_t));
+    pf->ticks = (uint64_t*)calloc(n, sizeof(uint64_t));
+    pf->fn    = (int32_t*)malloc(VM_FRAMES_INIT * sizeof(int32_t));
+    if(!pf->hits || !pf->calls || !pf->ticks || !pf->fn){ profile_free(pf); return 0; }
+    pf->fcap = VM_FRAMES_INIT;
+    pf->fn[0] = 0; pf->fsp = 1;
+    pf->calls[0] = 1;
+    pf->wall0 = wall_now();
+    pf->t_last = prof_now();
+    return 1;
+}
+
+/* vergangene Zeit an die aktive Funktion */
+static inline void profile_switch(Profile* pf){
+    uint64_t t = prof_now();
+    pf->ticks[pf->fn[pf->fsp - 1]] += t - pf->t_last;
+    pf->t_total += t - pf->t_last;
+    pf->t_last = t;
+}
+
+static void profile_call(Profile* pf, int32_t entry){
+    profile_switch(pf);
+    pf->calls[entry]++;
+    if(pf->lost || (pf->fsp == pf->fcap && !vm_grow((void**)&pf->fn, &pf->fcap, (int64_t)pf->fsp + 1, VM_MAX_FRAMES, sizeof(int32_t)))){
+        pf->lost++;
+        return;
+    }
+    pf->fn[pf->fsp++] = entry;
+}
+
+static void profile_tail(Profile* pf, int32_t entry){
+    profile_switch(pf);
+    pf->calls[entry]++;
+    if(!pf->lost) pf->fn[pf->fsp - 1] = entry;
+}
+
+static void profile_ret(Profile* pf){
+    profile_switch(pf);
+    if(pf->lost) pf->lost--;
+    else if(pf->fsp > 1) pf->fsp--;
+}
+
+/* Berichtszeile: count sortiert, aux = Zusatzspalte (Rücksprünge, Aufrufe) */
+typedef struct { uint64_t count, aux; int64_t key; uint32_t lo, hi; } ProfEnt;
+
+static int prof_ent_cmp(const void* x, const void* y){
+    const ProfEnt* a = (const ProfEnt*)x; const ProfEnt* b = (const ProfEnt*)y;
+    if(a->count != b->count) return (a->count < b->count) - (a->count > b->count);
+    return (a->key > b->key) - (a->key < b->key);
+}
+static int prof_key_cmp(const void* x, const void* y){
+    const ProfEnt* a = (const ProfEnt*)x; const ProfEnt* b = (const ProfEnt*)y;
+    return (a->key > b->key) - (a->key < b->key);
+}
+
+/* Zeile als Text: "line N" bzw. ohne Debug-Sektion "pc N" */
+static const char* prof_where(char* buf, size_t n, const DebugInfo* di, uint32_t pc){
+    int line = debug_line(di, pc);
+    if(line > 0) snprintf(buf, n, "line %d", line);
+    else snprintf(buf, n, "pc %u", pc);
+    return buf;
+}
+
+static void profile_report(const Program* pr, Profile* pf, FILE* out){
+    uint32_t n = pr->ninsns;
+    uint32_t* pcs = insn_offsets(pr);
+    ProfEnt* e = (ProfEnt*)calloc((size_t)n + 256, sizeof(ProfEnt));
+    if(!pcs || !e){ fprintf(out, "-- profile: out of memory --\n"); free(pcs); free(e); return; }
+    DebugInfo di;
+    int have_lines = debug_open(pr, &di) && di.nrows;
+    double ms_per_tick = pf->t_total ? (double)pf->wall_ns * 1e-6 / (double)pf->t_total : 0.0;
+    uint64_t total = 0;
+    for(uint32_t i = 0; i < n; i++) total += pf->hits[i];
+    double tot = total ? (double)total : 1.0;
+    char w1[32], w2[32];
+    size_t k;
+
+    fprintf(out, "-- profile: %llu instructions, %.3f ms%s --\n", (unsigned long long)total,
+            (double)pf->wall_ns * 1e-6, have_lines ? "" : " (no line table)");
+
+    /* Opcodes */
+    memset(e, 0, 256 * sizeof(ProfEnt));
+    for(uint32_t i = 0; i < n; i++){ e[pr->insns[i].op & 0xFF].count += pf->hits[i]; }
+    for(int op = 0; op < 256; op++) e[op].key = op;
+    qsort(e, 256, sizeof(ProfEnt), prof_ent_cmp);
+    fprintf(out, "-- opcodes --\n");
+    for(k = 0; k < 20 && e[k].count; k++)
+        fprintf(out, "%12llu %5.1f%%  %s\n", (unsigned long long)e[k].count, 100.0 * (double)e[k].count / tot, nova_op_name((int)e[k].key));
+
+    /* Quellzeilen: Instruktionen nach Zeile zusammenfassen */
+    if(have_lines){
+        size_t m = 0;
+        for(uint32_t i = 0; i < n; i++){
+            if(!pf->hits[i]) continue;
+            e[m].key = debug_line(&di, pcs[i]); e[m].count = pf->hits[i]; m++;
+        }
+        qsort(e, m, sizeof(ProfEnt), prof_key_cmp);
+        size_t u = 0;
+        for(size_t j = 0; j < m; j++){
+            if(u && e[u-1].key == e[j].key) e[u-1].count += e[j].count;
+            else e[u++] = e[j];
+        }
+        qsort(e, u, sizeof(ProfEnt), prof_ent_cmp);
+        fprintf(out, "-- hot lines --\n");
+        for(k = 0; k < 20 && k < u; k++)
+            fprintf(out, "%12llu %5.1f%%  line %lld\n", (unsigned long long)e[k].count, 100.0 * (double)e[k].count / tot, (long long)e[k].key);
+    }
+
+    /* einzelne Instruktionen */
+    size_t m = 0;
+    for(uint32_t i = 0; i < n; i++) if(pf->hits[i]){ e[m].key = i; e[m].count = pf->hits[i]; m++; }
+    qsort(e, m, sizeof(ProfEnt), prof_ent_cmp);
+    fprintf(out, "-- hot instructions --\n");
+    for(k = 0; k < 10 && k < m; k++){
+        uint32_t i = (uint32_t)e[k].key;
+        fprintf(out, "%12llu %5.1f%%  pc %-6u %-9s %s\n", (unsigned long long)e[k].count, 100.0 * (double)e[k].count / tot,
+                pcs[i], have_lines ? prof_where(w1, sizeof(w1), &di, pcs[i]) : "", nova_op_name(pr->insns[i].op));
+    }
+
+    /* Schleifen: Rückwärtssprung i -> t, Rumpf [t, i] */
+    m = 0;
+    for(uint32_t i = 0; i < n; i++){
+        const Insn* in = &pr->insns[i];
+        int32_t t;
+        switch(in->op){
+            case OP_JMP: case OP_JZ: case OP_JNZ: t = in->a; break;
+            case OP_LOAD_LOAD_LT_JZ: case OP_LOCAL_LOCAL_LT_JZ:
+            case OP_LOAD_LEN_LT_JZ: case OP_LOCAL_LEN_LT_JZ: t = in->c; break;
+            default: continue;
+        }
+        if(t > (int32_t)i || !pf->hits[i]) continue;
+        uint64_t sum = 0;
+        for(uint32_t j = (uint32_t)t; j <= i; j++) sum += pf->hits[j];
+        e[m].key = i; e[m].lo = (uint32_t)t; e[m].hi = i; e[m].count = sum; e[m].aux = pf->hits[i]; m++;
+    }
+    qsort(e, m, sizeof(ProfEnt), prof_ent_cmp);
+    if(m) fprintf(out, "-- hot loops --\n");
+    for(k = 0; k < 10 && k < m; k++){
+        int lo = 0, hi = 0;
+        for(uint32_t j = e[k].lo; have_lines && j <= e[k].hi; j++){
+            int l = debug_line(&di, pcs[j]);
+            if(l > 0 && (!lo || l < lo)) lo = l;
+            if(l > hi) hi = l;
+        }
+        if(lo) snprintf(w1, sizeof(w1), "lines %d-%d", lo, hi);
+        else   snprintf(w1, sizeof(w1), "pc %u-%u", pcs[e[k].lo], pcs[e[k].hi]);
+        fprintf(out, "%12llu %5.1f%%  %-14s %llu back-edges\n", (unsigned long long)e[k].count, 100.0 * (double)e[k].count / tot,
+                w1, (unsigned long long)e[k].aux);
+    }
+
+    /* Funktionen nach Eigenzeit */
+    m = 0;
+    for(uint32_t i = 0; i < n; i++){
+        if(!pf->calls[i]) continue;
+        e[m].key = i; e[m].count = pf->ticks[i]; e[m].aux = pf->calls[i]; m++;
+    }
+    qsort(e, m, sizeof(ProfEnt), prof_ent_cmp);
+    double tt = pf->t_total ? (double)pf->t_total : 1.0;
+    fprintf(out, "-- functions (self time) --\n%12s %10s %6s\n", "calls", "ms", "%");
+    for(k = 0; k < 20 && k < m; k++){
+        uint32_t i = (uint32_t)e[k].key;
+        const char* name = i == 0 ? "<main>" : debug_func(&di, pcs[i]);
+        if(!name){ snprintf(w2, sizeof(w2), "func@pc %u", pcs[i]); name = w2; }
+        fprintf(out, "%12llu %10.3f %5.1f%%  %s", (unsigned long long)e[k].aux, (double)e[k].count * ms_per_tick,
+                100.0 * (double)e[k].count / tt, name);
+        if(i && have_lines) fprintf(out, " (%s)", prof_where(w1, sizeof(w1), &di, pcs[i]));
+        fputc('\n', out);
+    }
+    debug_close(&di);
+    free(pcs); free(e);
+}
+
+#define INTERP_FN interp
+#include "interp.inc"
+#undef INTERP_FN
+#define INTERP_FN interp_prof
+#define INTERP_PROF 1
+#include "interp.inc"
+#undef INTERP_FN
+#undef INTERP_PROF
+#define INTERP_FN interp_jit
+#define INTERP_JIT 1
+#include "interp.inc"
+#undef INTERP_FN
+#undef INTERP_JIT
+#define INTERP_FN interp_budget
+#define INTERP_BUDGET 1
+#include "interp.inc"
+#undef INTERP_FN
+#undef INTERP_BUDGET
+#define INTERP_FN interp_profile
+#define INTERP_PROFILE 1
+#include "interp.inc"
+#undef INTERP_FN
+#undef INTERP_PROFILE
+
+/* ---- Register-Flavour ----
+ * Wie translate_program: Registeroperanden gegen nregs, String-Ids gegen den
+ * Pool und Sprungziele (immer der letzte Operand) gegen Instruktionsgrenzen
+ * prüfen; Sprungziele werden absolut. */
+static int translate_regs(Program* pr){
+    const uint8_t* code = pr->code;
+    uint32_t n = pr->code_len;
+    uint32_t* start = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if(!start){ load_err(pr, "oom"); return 0; }
+    uint32_t count = 0;
+    for(uint32_t pc=0; pc<n; ){
+        int k = nova_rop_noperands(code[pc]);
+        if(k < 0){ load_err_pc(pr, pc, "unknown opcode %u", code[pc]); free(start); return 0; }
+        if((uint64_t)pc + 1 + 4u*(uint32_t)k > n){ load_err_pc(pr, pc, "truncated operand"); free(start); return 0; }
+        start[count++] = pc;
+        pc += 1 + 4u*(uint32_t)k;
+    }
+    start[count] = n;
+
+    Insn* out = (Insn*)calloc((size_t)count + 1, sizeof(Insn));
+    if(!out){ load_err(pr, "oom"); free(start); return 0; }
+#ifdef NOVA_THREADED
+    const void* const* handlers = NULL;
+    interp_reg(NULL, &handlers);
+#endif
+    int ok = 1;
+    Insn* ins = out;
+    for(uint32_t pc=0; pc<n && ok; ins++){
+        uint8_t op = code[pc];
+        int k = nova_rop_noperands(op);
+        uint32_t next = pc + 1 + 4u*(uint32_t)k;
+        int32_t v[3] = {0,0,0};
+        for(int j=0;j<k;j++) v[j] = read_i32(&code[pc + 1 + 4*j]);
+        int is_jump = (op==R_JMP || op==R_JZ || op==R_JLT || op==R_JLE || op==R_JEQ || op==R_JNE);
+        if(is_jump){
+            int32_t t = insn_index(start, count, (int64_t)next + v[k-1]);
+            if(t < 0){ load_err_pc(pr, pc, "bad jump target"); ok = 0; break; }
+            v[k-1] = t;
+        }
+        /* Registeroperanden prüfen: alle außer Sprungziel und Immediate */
+        int nreg = is_jump ? k-1 : k;
+        if(op==R_MOVI || op==R_MOVS) nreg = 1;
+        for(int j=0;j<nreg;j++){
+            if(v[j] < 0 || (uint32_t)v[j] >= pr->nregs){ load_err_pc(pr, pc, "bad register %d", v[j]); ok = 0; }
+        }
+        if(op==R_MOVS && (v[1] < 0 || (uint32_t)v[1] >= pr->nstrs)){ load_err_pc(pr, pc, "bad string id %d", v[1]); ok = 0; }
+        ins->op = op; ins->a = v[0]; ins->b = v[1]; ins->c = v[2];
+#ifdef NOVA_THREADED
+        ins->h = handlers[op];
+#endif
+        pc = next;
+    }
+    free(start);
+    if(!ok){ free(out); return 0; }
+    out[count].op = R_HALT;
+#ifdef NOVA_THREADED
+    out[count].h = handlers[R_HALT];
+#endif
+    pr->insns = out;
+    pr->ninsns = count;
+    return 1;
+}
+
+/* Interpreter für den Register-Flavour; gleiche Dispatch-Varianten wie
+ * interp, Werte und Fehlermeldungen identisch zum Stack-Code. */
+static int interp_reg(NovaVM* vm, const void* const** handlers){
+#ifdef NOVA_THREADED
+    static const void* const jt[256] = {
+        [R_HALT]=&&R_L_HALT, [R_MOVI]=&&R_L_MOVI, [R_MOVS]=&&R_L_MOVS, [R_MOV]=&&R_L_MOV,
+        [R_ADD]=&&R_L_ADD, [R_SUB]=&&R_L_SUB, [R_MUL]=&&R_L_MUL, [R_DIV]=&&R_L_DIV, [R_MOD]=&&R_L_MOD,
+        [R_EQ]=&&R_L_EQ, [R_NE]=&&R_L_NE, [R_LT]=&&R_L_LT, [R_LE]=&&R_L_LE, [R_GT]=&&R_L_GT, [R_GE]=&&R_L_GE,
+        [R_AND]=&&R_L_AND, [R_OR]=&&R_L_OR, [R_NOT]=&&R_L_NOT,
+        [R_JMP]=&&R_L_JMP, [R_JZ]=&&R_L_JZ, [R_JLT]=&&R_L_JLT, [R_JLE]=&&R_L_JLE,
+        [R_JEQ]=&&R_L_JEQ, [R_JNE]=&&R_L_JNE,
+        [R_PRINT]=&&R_L_PRINT, [R_PRINTLN]=&&R_L_PRINTLN
+    };
+    if(handlers){ *handlers = jt; return 0; }
+#else
+    (void)handlers;
+#endif
+    const Program* pr = vm->pr;
+    Value* r = (Value*)calloc(pr->nregs ? pr->nregs : 1, sizeof(Value));
+    if(!r){ vm->error = "out of memory"; return NOVA_ERROR; }
+    int rc = NOVA_DONE;
+    const Insn* base = pr->insns;
+    const Insn* ip = base;
+    const Insn* in;
+    /* R_ADD..R_OR in derselben Reihenfolge wie OP_ADD..OP_OR (opcodes.h) */
+    #define FAIL(msg) do { out_flush(&vm->out); vm->error = (msg); vm->err_insn = (uint32_t)(in - base); rc = NOVA_ERROR; goto done; } while(0)
+    #define SLOW(op, a, b, r) do { const char* e_ = value_binop((op), (a), (b), &(r)); if(e_) FAIL(e_); } while(0)
+    #define BIN(cond, fast) do { Value a = r[in->b], b = r[in->c], v_; \
+        if(V_LIKELY(cond)) v_ = (fast); else SLOW(in->op - R_ADD + OP_ADD, a, b, v_); r[in->a] = v_; } while(0)
+    #define JCMP(o, cmp) do { Value a = r[in->a], b = r[in->b], v_; \
+        if(V_LIKELY(V_BOTH_INT(a,b))) v_ = V_BOOL(cmp); else SLOW(o, a, b, v_); \
+        if(V_TRUTHY(v_)) ip = base + in->c; } while(0)
+#ifdef NOVA_THREADED
+    #define CASE(o)   R_L_##o
+    #define NEXT()    do { in = ip++; goto *in->h; } while(0)
+    NEXT();
+    { { /* gleiche Klammertiefe wie for/switch im anderen Zweig */
+#else
+    #define CASE(o)   case R_##o
+    #define NEXT()    continue
+    for(;;){
+        in = ip++;
+        switch(in->op){
+#endif
+            CASE(HALT): goto done;
+            CASE(MOVI): r[in->a] = V_INT(in->b); NEXT();
+            CASE(MOVS): r[in->a] = V_STR(in->b); NEXT();
+            CASE(MOV):  r[in->a] = r[in->b]; NEXT();
+            CASE(ADD): BIN(V_BOTH_INT(a,b), V_ADD(a,b)); NEXT();
+            CASE(SUB): BIN(V_BOTH_INT(a,b), V_SUB(a,b)); NEXT();
+            CASE(MUL): BIN(V_BOTH_INT(a,b), V_MUL(a,b)); NEXT();
+            CASE(DIV): BIN(V_BOTH_INT(a,b) && b!=0, V_DIV(a,b)); NEXT();
+            CASE(MOD): BIN(V_BOTH_INT(a,b) && b!=0, V_MOD(a,b)); NEXT();
+            CASE(EQ):  BIN(V_BOTH_INT(a,b), V_BOOL(a==b)); NEXT();
+            CASE(NE):  BIN(V_BOTH_INT(a,b), V_BOOL(a!=b)); NEXT();
+            CASE(LT):  BIN(V_BOTH_INT(a,b), V_BOOL(a<b)); NEXT();
+            CASE(LE):  BIN(V_BOTH_INT(a,b), V_BOOL(a<=b)); NEXT();
+            CASE(GT):  BIN(V_BOTH_INT(a,b), V_BOOL(a>b)); NEXT();
+            CASE(GE):  BIN(V_BOTH_INT(a,b), V_BOOL(a>=b)); NEXT();
+            CASE(AND): BIN(1, V_BOOL(V_TRUTHY(a) && V_TRUTHY(b))); NEXT();
+            CASE(OR):  BIN(1, V_BOOL(V_TRUTHY(a) || V_TRUTHY(b))); NEXT();
+            CASE(NOT): r[in->a] = V_BOOL(!V_TRUTHY(r[in->b])); NEXT();
+            CASE(JMP): ip = base + in->a; NEXT();
+            CASE(JZ):  if(!V_TRUTHY(r[in->a])) ip = base + in->b; NEXT();
+            CASE(JLT): JCMP(OP_LT, a <  b); NEXT();
+            CASE(JLE): JCMP(OP_LE, a <= b); NEXT();
+            CASE(JEQ): JCMP(OP_EQ, a == b); NEXT();
+            CASE(JNE): JCMP(OP_NE, a != b); NEXT();
+            CASE(PRINT):
+            CASE(PRINTLN): {
+                if(vm_print(&vm->out, pr, r[in->a], in->op==R_PRINTLN)) FAIL("bad string id");
+            } NEXT();
+#ifndef NOVA_THREADED
+            default:
+                FAIL("unknown opcode");
+#endif
+        }
+    }
+done:
+    free(r);
+    return rc;
+    #undef FAIL
+    #undef SLOW
+    #undef BIN
+    #undef JCMP
+    #undef CASE
+    #undef NEXT
+}
+
+/* Führt vm->pr mit gewählter Engine aus (siehe nova_vm_run) */
+static int run_program(NovaVM* vm, uint64_t budget){
+    const Program* pr = vm->pr;
+    if(pr->regs){
+        if(budget){ vm->error = "step budget: not supported for register bytecode"; return NOVA_ERROR; }
+        return interp_reg(vm, NULL);
+    }
+    /* Bedarf des Hauptprogramms; Funktionen reservieren CALL/TAILCALL */
+    if((int64_t)pr->stack_need > vm->scap &&
+       !vm_grow((void**)&vm->stack, &vm->scap, pr->stack_need, VM_STACK_MAX, sizeof(Value))){
+        vm->error = "stack overflow"; return NOVA_ERROR;
+    }
+    if(budget) return interp_budget(vm, NULL, &budget);
+    if(vm->profiling){
+        if(!profile_reset(&vm->profile, pr->ninsns)){ vm->error = "profile: out of memory"; return NOVA_ERROR; }
+        int rc = interp_profile(vm, NULL, &vm->profile);
+        profile_switch(&vm->profile);
+        vm->profile.wall_ns = wall_now() - vm->profile.wall0;
+        return rc;
+    }
+    if(vm->ngram){
+        prof_reset(&vm->prof);
+        vm->prof.ngram = vm->ngram;
+        return interp_prof(vm, NULL, &vm->prof);
+    }
+    if(vm->jit_mode != JIT_OFF){
+        Jit* jit = jit_new(pr, vm->jit_mode);
+        if(jit){
+            int rc = interp_jit(vm, NULL, jit);
+            jit_free(jit);
+            return rc;
+        }
+    }
+    return interp(vm, NULL, NULL);
+}
+
+NovaVM* nova_vm_new(const NovaProgram* pr){
+    NovaVM* vm = (NovaVM*)calloc(1, sizeof(NovaVM));
+    if(!vm) return NULL;
+    vm->pr = pr;
+    vm->vars   = (Value*)calloc(pr->nvars ? pr->nvars : 1, sizeof(Value));
+    vm->stack  = (Value*)malloc(VM_STACK_SLOTS * sizeof(Value));
+    vm->frames = (VmFrame*)malloc(VM_FRAMES_INIT * sizeof(VmFrame));
+    vm->scap = VM_STACK_SLOTS; vm->fcap = VM_FRAMES_INIT;
+    if(!vm->vars || !vm->stack || !vm->frames || !out_init(&vm->out, OUT_DEFAULT_BUFFER, NULL, NULL)){
+        nova_vm_free(vm); return NULL;
+    }
+    return vm;
+}
+
+void nova_vm_free(NovaVM* vm){
+    if(!vm) return;
+    out_free(&vm->out);
+    value_heap_free(&vm->heap);
+    free(vm->prof.tab);
+    profile_free(&vm->profile);
+    free(vm->vars); free(vm->stack); free(vm->frames);
+    free(vm);
+}
+
+int nova_vm_set_output(NovaVM* vm, NovaWriteFn fn, void* user, size_t bufsize){
+    return out_init(&vm->out, bufsize, fn, user);
+}
+
+int nova_vm_set_jit(NovaVM* vm, int mode){
+    vm->jit_mode = mode;
+    return mode == NOVA_JIT_OFF || (jit_available() && !vm->pr->regs);
+}
+
+int nova_vm_set_ngrams(NovaVM* vm, int n){
+    if(n < 0 || n > 4) return 0;
+    vm->ngram = n;
+    return n == 0 || !vm->pr->regs;
+}
+
+int nova_vm_set_profile(NovaVM* vm, int on){
+    vm->profiling = on;
+    return !on || !vm->pr->regs;
+}
+
+int nova_vm_run(NovaVM* vm, uint64_t budget){
+    if(vm->state == VM_FRESH){
+        /* neuer Lauf: Globals 0, Arrays des letzten Laufs freigeben */
+        memset(vm->vars, 0, vm->pr->nvars * sizeof(Value));
+        value_heap_free(&vm->heap);
+        vm->sp = vm->fsp = vm->fp = 0; vm->ip = 0;
+    }
+    vm->error = NULL;
+    vm->err_insn = UINT32_MAX;
+    int rc = run_program(vm, budget);
+    if(rc == NOVA_ERROR && vm->err_insn != UINT32_MAX){
+        /* Position erst jetzt bestimmen: Byte-Offset, Zeile aus der Debug-Sektion */
+        char where[64];
+        debug_where(vm->pr, insn_pc(vm->pr, vm->err_insn), where, sizeof(where));
+        snprintf(vm->errbuf, sizeof(vm->errbuf), "%s%s", vm->error, where);
+        vm->error = vm->errbuf;
+    }
+    vm->state = rc == NOVA_SUSPENDED ? VM_SUSPENDED : VM_FRESH;
+    out_flush(&vm->out);
+    return rc;
+}
+
+const char* nova_vm_error(const NovaVM* vm){
+    return vm->error ? vm->error : "";
+}
+
+void nova_vm_report(NovaVM* vm, FILE* out){
+    if(vm->prof.ngram) prof_report(&vm->prof, out);
+    if(vm->profile.hits){
+        profile_report(vm->pr, &vm->profile, out);
+        profile_free(&vm->profile);
+    }
+}